@@ -2054,12 +2054,17 @@ fill_linbuf(
                             killslot(tcol, curr_outrow);
                     }
 
+                    /* killslot() looks in the trees, so only batch each row's pair */
+                    ev_uref_batch_start();
+
                     /* anything pointing to deleted cells in this row become bad */
                     updref(0, currow,     LARGEST_COL_POSSIBLE, currow,               BADCOLBIT, (ROW) 0, UREF_DELETE, DOCNO_NONE);
 
                     /* rows in all those columns move up */
                     updref(0, currow + 1, LARGEST_COL_POSSIBLE, LARGEST_ROW_POSSIBLE, (COL) 0, (ROW) -1, UREF_UREF, DOCNO_NONE);
 
+                    ev_uref_batch_end();
+
                     mark_row(currowoffset - 1);
                 }
                 else
@@ -20,10 +20,27 @@
 /* local header file */
 #include "ev_evali.h"
 
+/*
+fold constant sub-expressions into the rpn at compile time;
+undefine to compile expressions verbatim
+*/
+
+#define EV_FOLD_CONSTANTS 1
+
 /*
 internal functions
 */
 
+#if defined(EV_FOLD_CONSTANTS)
+
+static void
+fold_constant(
+    P_U8 fold_start);
+
+#else
+#define fold_constant(fold_start) UNREFERENCED_PARAMETER(fold_start)
+#endif
+
 static void
 out_byte(
     U8 u8);
@@ -435,6 +452,248 @@ ss_recog_constant(
     return(res > 0 ? in_pos - in_str : res);
 }
 
+#if defined(EV_FOLD_CONSTANTS)
+
+/******************************************************************************
+*
+* evaluate one step of a constant sub-expression
+*
+* --out--
+* FALSE if the step can't be done at compile time
+*
+******************************************************************************/
+
+#define FOLD_STACK_MAX 16
+
+static BOOL
+fold_constant_step(
+    _InVal_     EV_IDNO rpn_num,
+    P_SS_DATA fold_stack,
+    _InoutRef_  P_S32 p_fold_sp)
+{
+    static const EV_SLR fold_slr; /* no functions that fold need a current cell */
+    P_SS_DATA args[EV_MAX_ARGS];
+    SS_DATA ss_data_res;
+    S32 n_args;
+
+    switch(rpn_num)
+    {
+    case RPN_BOP_PLUS:
+    case RPN_BOP_MINUS:
+    case RPN_BOP_TIMES:
+    case RPN_BOP_DIVIDE:
+        {
+        P_SS_DATA p_ss_data_1, p_ss_data_2;
+        bool done;
+
+        if(*p_fold_sp < 2)
+            return(FALSE);
+
+        p_ss_data_1 = &fold_stack[*p_fold_sp - 2];
+        p_ss_data_2 = &fold_stack[*p_fold_sp - 1];
+
+        /* only fold what eval_optimise would have done at recalc time */
+        switch(rpn_num)
+        {
+        case RPN_BOP_PLUS:
+            done = two_nums_add_try(p_ss_data_1, p_ss_data_1, p_ss_data_2);
+            break;
+        case RPN_BOP_MINUS:
+            done = two_nums_subtract_try(p_ss_data_1, p_ss_data_1, p_ss_data_2);
+            break;
+        case RPN_BOP_TIMES:
+            done = two_nums_multiply_try(p_ss_data_1, p_ss_data_1, p_ss_data_2);
+            break;
+        default:
+            done = two_nums_divide_try(p_ss_data_1, p_ss_data_1, p_ss_data_2);
+            break;
+        }
+
+        if(!done)
+            return(FALSE);
+
+        --*p_fold_sp;
+        return(TRUE);
+        }
+
+    case RPN_UOP_UMINUS:
+    case RPN_UOP_UPLUS:
+        if(*p_fold_sp < 1)
+            return(FALSE);
+        args[0] = &fold_stack[*p_fold_sp - 1];
+        n_args = 1;
+        break;
+
+    case RPN_FN0_PI:
+        if(*p_fold_sp >= FOLD_STACK_MAX)
+            return(FALSE);
+        ++*p_fold_sp;
+        n_args = 0;
+        break;
+
+    default:
+        return(FALSE);
+    }
+
+    ss_data_init(&ss_data_res);
+    (*rpn_table[rpn_num].p_proc_exec) (args, n_args, &ss_data_res, &fold_slr);
+    fold_stack[*p_fold_sp - 1] = ss_data_res;
+    return(TRUE);
+}
+
+/******************************************************************************
+*
+* try to fold the rpn output since fold_start into a constant
+*
+* only numbers, PI() and the arithmetic that eval_optimise
+* handles are folded, so the result is exactly what recalc would
+* produce; NOW(), RAND() and friends are never touched
+*
+* the original rpn is kept for the decompiler, preceded by
+* RPN_FRM_FOLD, the length to skip and the folded constant;
+* any folds nested inside the original rpn are removed
+*
+******************************************************************************/
+
+static void
+fold_constant(
+    P_U8 fold_start)
+{
+    SS_DATA fold_stack[FOLD_STACK_MAX];
+    S32 fold_sp = 0;
+    BOOL did_op = FALSE;
+    RPNSTATE rpnb;
+    U8 fold_buf[sizeof32(EV_IDNO) + sizeof32(S16) + sizeof32(EV_IDNO) + sizeof32(F64)];
+    U32 fold_len, rpn_len;
+    P_U8 out_pos;
+
+    if(cc->error)
+        return;
+
+    /* need room for the largest constant; this also keeps the scans below inside the buffer */
+    if(((cc->op_pos - cc->op_start) + (S32) sizeof32(fold_buf)) > cc->op_maxlen)
+        return;
+
+    rpnb.pos = fold_start;
+    rpn_check(&rpnb);
+
+    while(rpnb.pos < cc->op_pos)
+    {
+        switch(rpnb.num)
+        {
+        case DATA_ID_REAL:
+        case DATA_ID_WORD16:
+        case DATA_ID_WORD32:
+            if(fold_sp >= FOLD_STACK_MAX)
+                return;
+            read_cur_sym(&rpnb, &fold_stack[fold_sp++]);
+            break;
+
+        case RPN_FRM_FOLD:
+            {
+            RPNSTATE rpn_fold;
+
+            if(fold_sp >= FOLD_STACK_MAX)
+                return;
+
+            rpn_fold.pos = rpnb.pos + 1 + sizeof(S16);
+            rpn_check(&rpn_fold);
+            read_cur_sym(&rpn_fold, &fold_stack[fold_sp++]);
+
+            rpnb.pos += readval_S16(rpnb.pos + 1);
+            rpn_check(&rpnb);
+            continue;
+            }
+
+        case RPN_FRM_BRACKETS:
+        case RPN_FRM_SPACE:
+        case RPN_FRM_RETURN:
+            break;
+
+        default:
+            if(!fold_constant_step(rpnb.num, fold_stack, &fold_sp))
+                return;
+
+            did_op = TRUE;
+
+            /* errors (e.g. divide by zero) are left for recalc to report */
+            switch(ss_data_get_data_id(&fold_stack[fold_sp - 1]))
+            {
+            case DATA_ID_REAL:
+            case DATA_ID_WORD16:
+            case DATA_ID_WORD32:
+                break;
+            default:
+                return;
+            }
+            break;
+        }
+
+        rpn_skip(&rpnb);
+    }
+
+    /* a lone number is as quick to push as its fold */
+    if((1 != fold_sp) || !did_op)
+        return;
+
+    if(PtrDiffBytesU32(cc->op_pos, fold_start) + sizeof32(fold_buf) > S16_MAX)
+        return;
+
+    fold_buf[0] = RPN_FRM_FOLD;
+    fold_buf[sizeof32(EV_IDNO) + sizeof32(S16)] = ss_data_get_data_id(&fold_stack[0]);
+    fold_len = sizeof32(EV_IDNO) + sizeof32(S16) + sizeof32(EV_IDNO);
+
+    switch(ss_data_get_data_id(&fold_stack[0]))
+    {
+    case DATA_ID_REAL:
+        memcpy32(fold_buf + fold_len, &fold_stack[0].arg.fp, sizeof32(F64));
+        fold_len += sizeof32(F64);
+        break;
+
+    case DATA_ID_WORD16:
+        writeval_S16(fold_buf + fold_len, (S16) ss_data_get_integer(&fold_stack[0]));
+        fold_len += sizeof32(S16);
+        break;
+
+    default:
+    case DATA_ID_WORD32:
+        memcpy32(fold_buf + fold_len, &fold_stack[0].arg.integer, sizeof32(S32));
+        fold_len += sizeof32(S32);
+        break;
+    }
+
+    /* strip nested folds, which recalc can no longer reach */
+    out_pos = fold_start;
+    rpnb.pos = fold_start;
+    rpn_check(&rpnb);
+
+    while(rpnb.pos < cc->op_pos)
+    {
+        PC_U8 token_pos = rpnb.pos;
+        const BOOL nested_fold = (RPN_FRM_FOLD == rpnb.num);
+
+        rpn_skip(&rpnb);
+
+        if(!nested_fold)
+        {
+            const U32 token_len = PtrDiffBytesU32(rpnb.pos, token_pos);
+            memmove32(out_pos, token_pos, token_len);
+            out_pos += token_len;
+        }
+    }
+
+    cc->op_pos = out_pos;
+    rpn_len = PtrDiffBytesU32(cc->op_pos, fold_start);
+
+    writeval_S16(fold_buf + sizeof32(EV_IDNO), /*(S16)*/ (fold_len + rpn_len));
+
+    memmove32(fold_start + fold_len, fold_start, rpn_len);
+    memcpy32(fold_start, fold_buf, fold_len);
+    cc->op_pos += fold_len;
+}
+
+#endif /* EV_FOLD_CONSTANTS */
+
 /******************************************************************************
 *
 * an internal or custom function call has been identified
@@ -2000,6 +2259,7 @@ static void
 rec_cterm(void)
 {
     SYM_INF sym_inf;
+    P_U8 fold_start = cc->op_pos;
 
     rec_dterm();
     for(;;)
@@ -2015,6 +2275,7 @@ rec_cterm(void)
         }
         rec_dterm();
         out_idno_format(&sym_inf);
+        fold_constant(fold_start);
     }
 }
 
@@ -2028,6 +2289,7 @@ static void
 rec_dterm(void)
 {
     SYM_INF sym_inf;
+    P_U8 fold_start = cc->op_pos;
 
     rec_eterm();
     for(;;)
@@ -2043,6 +2305,7 @@ rec_dterm(void)
         }
         rec_eterm();
         out_idno_format(&sym_inf);
+        fold_constant(fold_start);
     }
 }
 
@@ -2124,10 +2387,16 @@ rec_fterm(void)
         sym_inf.sym_idno = RPN_UOP_UMINUS;
     case RPN_UOP_NOT:
     proc_op:
+        {
+        P_U8 fold_start = cc->op_pos;
+
         cc->cur.sym_idno = SYM_BLANK;
         rec_fterm();
         out_idno_format(&sym_inf);
+        if(sym_inf.sym_idno != RPN_UOP_NOT)
+            fold_constant(fold_start);
         return;
+        }
     default:
         rec_gterm();
         return;
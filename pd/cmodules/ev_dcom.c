@@ -432,6 +432,7 @@ dec_rpn_token(
         case RPN_FRM_SKIPTRUE:
         case RPN_FRM_SKIPFALSE:
         case RPN_FRM_NODEP:
+        case RPN_FRM_FOLD:
             len = -1;
             break;
         }
@@ -848,6 +849,24 @@ fptostr(
     P_U8 exp;
     S32 len;
 
+    /* whole numbers are common enough to be worth doing without sprintf() */
+    {
+    const BOOL negative = (fpval < 0.0);
+    U32 n_digits;
+
+    if(negative)
+        op_buf[0] = '-';
+
+    if(0 != (n_digits = fast_dtoa_integral(op_buf + negative, 16, negative ? -fpval : fpval)))
+    {
+        len = (S32) n_digits + negative;
+        op_buf[len++] = CH_FULL_STOP;
+        op_buf[len++] = CH_DIGIT_ZERO;
+        op_buf[len  ] = CH_NULL;
+        return(len);
+    }
+    } /*block*/
+
     len = sprintf(op_buf, "%.15g", fpval);
     op_buf[len] = CH_NULL;
 
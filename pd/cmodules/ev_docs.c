@@ -372,6 +372,7 @@ doc_free(
 
         doc_free_table(&p_ss_doc->exttab);
         doc_free_table(&p_ss_doc->range_table);
+        tree_rng_itree_dispose(p_ss_doc);
         doc_free_table(&p_ss_doc->slr_table);
 
         ev_destroy_ss_doc(docno);
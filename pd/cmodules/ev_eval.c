@@ -120,6 +120,8 @@ data
 
 EV_SERIAL ev_serial_num = 1;
 
+U32 ev_recalc_cells_calced = 0; /* count of cells evaluated, for reporting */
+
 static P_STACK_ENTRY stack_base = NULL;
 static P_STACK_ENTRY stack_end  = NULL;
 static P_STACK_ENTRY stack_ptr  = NULL;
@@ -780,6 +782,22 @@ eval_rpn(
                 continue;
                 }
 
+            /* constant folded by the compiler: push it and skip the original rpn */
+            case RPN_FRM_FOLD:
+                {
+                RPNSTATE rpn_fold;
+
+                rpn_fold.pos = rpnb.pos + 1 + sizeof(S16);
+                rpn_check(&rpn_fold);
+
+                stack_inc(DATA_ITEM, cur_slr, stack_ptr[-1].stack_flags);
+                read_cur_sym(&rpn_fold, &stack_ptr->data.stack_data_item.data);
+
+                rpnb.pos += readval_S16(rpnb.pos + 1);
+                rpn_check(&rpnb);
+                continue;
+                }
+
             /* most formatting bits are ignored in evaluation */
             case RPN_FRM_BRACKETS:
             case RPN_FRM_RETURN:
@@ -1040,6 +1058,7 @@ eval_rpn(
                                 stack_dbase.cond_pos = (S32) args[1]->arg.cond_pos;
                                 stack_dbase.offset.col = 0;
                                 stack_dbase.offset.row = 0;
+                                stack_dbase.p_dbase_cond = NULL;
                                 dbase_stat_block_init(stack_dbase.p_stat_block,
                                                       (U32) func_data->parms.no_exec);
 
@@ -2145,6 +2164,31 @@ ev_recalc(void)
 
                     if(circ_check(p_ev_cell) == NEW_STATE)
                         break;
+
+                    /* constant data has no supporters and is never calculated,
+                     * so don't bother going round CALC_SLOT and END_CALC for it
+                     */
+                    if( (p_ev_cell->parms.type == EVS_CON_DATA)                      &&
+                        !doc_check_is_custom(stack_ptr->slr.docno)                    &&
+                        !((p_ev_cell->ev_result.data_id == DATA_ID_ERROR)            &&
+                          (p_ev_cell->ev_result.arg.ss_error.status == STATUS_NOMEM)) )
+                    {
+                        eval_trace("<visit_slot> constant data");
+
+                        p_ev_cell->parms.circ = 0;
+
+                        /* remove this cell's entry from the todo list */
+                        todo_remove_slr(&stack_ptr->slr);
+
+                        /* continue with what we were doing previously */
+                        if(!stack_offset(stack_ptr))
+                            /* if no previous it's all done */
+                            complete = 1;
+                        else
+                            --stack_ptr;
+
+                        break;
+                    }
                 }
 
                 /* check we have enough stack to push current state
@@ -2244,6 +2288,8 @@ ev_recalc(void)
                 stack_ptr->data.stack_in_calc.did_calc = 1;
                 stack_ptr->data.stack_in_calc.type = INCALC_SLR;
 
+                ++ev_recalc_cells_calced;
+
                 eval_rpn(stack_offset(stack_ptr));
             }
             else
@@ -2419,75 +2465,85 @@ ev_recalc(void)
          */
         case DBASE_FUNCTION:
             {
-            P_EV_CELL p_ev_cell;
             S32 error = 0;
+            EV_SLR slr;
 
-            /* set up conditional string ready for munging */
-            if(ev_travel(&p_ev_cell, &stack_ptr->data.stack_dbase.dbase_slot) > 0)
+            /* calculate slr for cell being processed conditionally */
+            slr = stack_ptr->data.stack_dbase.dbase_rng.s;
+
+            /* check for errors with external refs */
+            if((slr.flags & SLR_EXT_REF) && ev_doc_error(slr.docno))
+                error = ev_doc_error(slr.docno);
+            else
             {
-                char dbase_rpn[EV_MAX_OUT_LEN + 1];
-                S32 rpn_len;
-                P_U8 rpn_ptr;
-                EV_SLR slr;
+                P_DBASE_COND p_dbase_cond = stack_ptr->data.stack_dbase.p_dbase_cond;
+                EV_SLR target_slr;
+                S32 abs_col, abs_row;
 
-                /* calculate slr for cell being processed conditionally */
-                slr = stack_ptr->data.stack_dbase.dbase_rng.s;
+                /* calculate slr of cell in database range */
+                slr.col += stack_ptr->data.stack_dbase.offset.col;
+                slr.row += stack_ptr->data.stack_dbase.offset.row;
 
-                /* check for errors with external refs */
-                if((slr.flags & SLR_EXT_REF) && ev_doc_error(slr.docno))
-                    error = ev_doc_error(slr.docno);
-                else
+                target_slr.col = stack_ptr->data.stack_dbase.offset.col;
+                target_slr.row = stack_ptr->data.stack_dbase.offset.row;
+                abs_col = abs_row = 0;
+
+                if(stack_ptr->data.stack_dbase.dbase_rng.s.col + 1 != stack_ptr->data.stack_dbase.dbase_rng.e.col)
                 {
-                    EV_SLR target_slr;
-                    S32 abs_col, abs_row;
+                    target_slr.col = slr.col;
+                    abs_col = 1;
+                }
 
-                    /* calculate slr of cell in database range */
-                    slr.col += stack_ptr->data.stack_dbase.offset.col;
-                    slr.row += stack_ptr->data.stack_dbase.offset.row;
+                if(stack_ptr->data.stack_dbase.dbase_rng.s.row + 1 != stack_ptr->data.stack_dbase.dbase_rng.e.row)
+                {
+                    target_slr.row = slr.row;
+                    abs_row = 1;
+                }
 
-                    target_slr.col = stack_ptr->data.stack_dbase.offset.col;
-                    target_slr.row = stack_ptr->data.stack_dbase.offset.row;
-                    abs_col = abs_row = 0;
+                /* compile the condition for the first cell;
+                 * after that, just point its SLRs at this cell
+                 */
+                if((NULL != p_dbase_cond) && !p_dbase_cond->recompile)
+                    dbase_cond_retarget(p_dbase_cond, &target_slr, abs_col, abs_row);
+                else
+                {
+                    P_EV_CELL p_ev_cell;
 
-                    if(stack_ptr->data.stack_dbase.dbase_rng.s.col + 1 != stack_ptr->data.stack_dbase.dbase_rng.e.col)
+                    if(ev_travel(&p_ev_cell, &stack_ptr->data.stack_dbase.dbase_slot) > 0)
                     {
-                        target_slr.col = slr.col;
-                        abs_col = 1;
-                    }
+                        if(NULL == p_dbase_cond)
+                            stack_ptr->data.stack_dbase.p_dbase_cond = p_dbase_cond = al_ptr_alloc_elem(DBASE_COND, 1, &error);
 
-                    if(stack_ptr->data.stack_dbase.dbase_rng.s.row + 1 != stack_ptr->data.stack_dbase.dbase_rng.e.row)
-                    {
-                        target_slr.row = slr.row;
-                        abs_row = 1;
+                        if(NULL != p_dbase_cond)
+                            dbase_cond_compile(p_dbase_cond,
+                                               p_ev_cell->rpn.var.rpn_str + stack_ptr->data.stack_dbase.cond_pos,
+                                               &target_slr, abs_col, abs_row);
                     }
+                    else
+                        error = create_error(EVAL_ERR_INTERNAL);
+                }
 
-                    rpn_len = ev_proc_conditional_rpn(dbase_rpn,
-                                                      p_ev_cell->rpn.var.rpn_str + stack_ptr->data.stack_dbase.cond_pos,
-                                                      &target_slr, abs_col, abs_row);
-
-                    if(NULL != (rpn_ptr = al_ptr_alloc_bytes(P_U8, rpn_len, &error)))
-                    {
-                        stack_inc(DBASE_CALC, slr, stack_ptr[-1].stack_flags);
-                        memcpy32(rpn_ptr, dbase_rpn, rpn_len);
+                if(!error)
+                {
+                    stack_inc(DBASE_CALC, slr, stack_ptr[-1].stack_flags);
 
-                        stack_ptr->data.stack_in_calc.eval_block.slr = slr;
-                        stack_ptr->data.stack_in_calc.eval_block.offset = 0;
-                        stack_ptr->data.stack_in_calc.ptr = rpn_ptr;
-                        stack_ptr->data.stack_in_calc.type = INCALC_PTR;
+                    stack_ptr->data.stack_in_calc.eval_block.slr = slr;
+                    stack_ptr->data.stack_in_calc.eval_block.offset = 0;
+                    stack_ptr->data.stack_in_calc.ptr = p_dbase_cond->rpn; /* owned by DBASE_FUNCTION */
+                    stack_ptr->data.stack_in_calc.type = INCALC_PTR;
 
-                        /* go to evaluate condition */
-                        eval_rpn(stack_offset(stack_ptr));
-                    }
+                    /* go to evaluate condition */
+                    eval_rpn(stack_offset(stack_ptr));
                 }
             }
-            else
-                error = create_error(EVAL_ERR_INTERNAL);
 
             /* on error, cancel function and pop previous state,
              * pushing error as result
              */
             if(error)
             {
+                al_ptr_dispose(P_P_ANY_PEDANTIC(&stack_ptr->data.stack_dbase.p_dbase_cond));
+
                 /* pop previous state */
                 stack_ptr[0] = stack_ptr[-1];
 
@@ -2503,9 +2559,6 @@ ev_recalc(void)
             {
             EV_SLR span;
 
-            /* throw away current conditional rpn string */
-            al_ptr_dispose((P_P_ANY) /*_PEDANTIC*/ (&stack_ptr->data.stack_in_calc.ptr));
-
             /* call the dbase routine to process the data */
             dbase_sub_function(&stack_ptr[-1].data.stack_dbase, &stack_ptr->data.stack_in_calc.result_data);
 
@@ -2530,6 +2583,7 @@ ev_recalc(void)
 
                     dbase_sub_function_finish(&data, &stack_ptr->data.stack_dbase);
                     al_ptr_dispose(P_P_ANY_PEDANTIC(&stack_ptr->data.stack_dbase.p_stat_block));
+                    al_ptr_dispose(P_P_ANY_PEDANTIC(&stack_ptr->data.stack_dbase.p_dbase_cond));
 
                     /* pop previous state
                      * push dbase result
@@ -2964,15 +3018,14 @@ stack_free_resources(
         lookup_block_dispose(&stkentp->data.stack_lookup);
         break;
 
-    /* free indirected stats block */
+    /* free indirected stats block and compiled condition */
     case DBASE_FUNCTION:
         al_ptr_dispose(P_P_ANY_PEDANTIC(&stkentp->data.stack_dbase.p_stat_block));
+        al_ptr_dispose(P_P_ANY_PEDANTIC(&stkentp->data.stack_dbase.p_dbase_cond));
         break;
 
-    /* free stored conditional rpn string */
+    /* conditional rpn string belongs to DBASE_FUNCTION below */
     case DBASE_CALC:
-        if(stkentp->data.stack_in_calc.ptr)
-            al_ptr_dispose((P_P_ANY) /*_PEDANTIC*/ (&stkentp->data.stack_in_calc.ptr));
         break;
 
     /* kill off an alert or input box */
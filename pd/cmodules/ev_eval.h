@@ -165,6 +165,7 @@ typedef struct UREF_PARM
     EV_SLR slr2;
     EV_SLR slr3;
     S32 action;
+    const EV_ROW * p_permute; /* UREF_PERMUTE only */
 }
 UREF_PARM, * P_UREF_PARM; typedef const UREF_PARM * PC_UREF_PARM;
 
@@ -196,7 +197,8 @@ enum UREF_ACTIONS
     UREF_CLOSE     ,
     UREF_REDRAW    ,
     UREF_ADJUST    ,
-    UREF_RENAME
+    UREF_RENAME    ,
+    UREF_PERMUTE
 };
 
 /*
@@ -319,6 +321,10 @@ typedef struct SS_DOC
     DEPTABLE range_table;               /* range dependent table */
     DEPTABLE exttab;                    /* external dependent table */
 
+    P_EV_COL rng_itree;                 /* interval index over sorted range table */
+    EV_TRENT rng_itree_n;               /* number of range table entries indexed */
+    S32 rng_itree_level;                /* level of root node of range index */
+
     S32 nam_ref_count;                  /* ref count of names (to this doc) */
     S32 custom_ref_count;               /* ref count of custom functions (to this doc) */
 
@@ -334,6 +340,9 @@ SS_DOC, * P_SS_DOC;
     DEPTABLE_INIT, \
     DEPTABLE_INIT, \
     DEPTABLE_INIT, \
+    NULL, \
+    0, \
+    0, \
     0, \
     0, \
     0  \
@@ -379,6 +388,7 @@ enum DID_NUMBERS
     RPN_FRM_SKIPFALSE   ,
     RPN_FRM_SKIPTRUE    ,
     RPN_FRM_NODEP       ,
+    RPN_FRM_FOLD        ,
 
     /* unary operators */
     RPN_UOP_NOT         ,
@@ -1258,6 +1268,8 @@ ev_recalc(void);
 extern void
 ev_recalc_all(void);
 
+extern U32 ev_recalc_cells_calced; /*const-to-you*/
+
 extern void
 ev_recalc_status(
     S32 to_calc);
@@ -1432,6 +1444,12 @@ extern void
 ev_uref(
     _InRef_     PC_UREF_PARM upp);
 
+extern void
+ev_uref_batch_end(void);
+
+extern void
+ev_uref_batch_start(void);
+
 /*
 outside evaluator
 */
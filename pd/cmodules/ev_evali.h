@@ -364,6 +364,19 @@ typedef struct ARRAY_SCAN_BLOCK
 }
 ARRAY_SCAN_BLOCK, * P_ARRAY_SCAN_BLOCK;
 
+/*
+array sorting keys, most significant first
+*/
+
+typedef struct ARRAY_SORT_KEY
+{
+    U32 x_index;                /* column to compare rows on */
+    BOOL descending;
+}
+ARRAY_SORT_KEY, * P_ARRAY_SORT_KEY; typedef const ARRAY_SORT_KEY * PC_ARRAY_SORT_KEY;
+
+#define ARRAY_SORT_KEYS_MAX EV_MAX_ARGS
+
 /*
 range scanning data
 */
@@ -508,6 +521,23 @@ typedef struct STACK_CONTROL_LOOP
 }
 STACK_CONTROL_LOOP, * P_STACK_CONTROL_LOOP;
 
+/*
+database condition compiled once for the database range:
+each cell rewrites the SLRs that were made from its ranges
+*/
+
+#define DBASE_COND_MAX_REFS (EV_MAX_OUT_LEN / (PACKED_SLRSIZE + 1))
+
+typedef struct DBASE_COND
+{
+    S32 n_refs;
+    BOOL recompile;                     /* names may change as we go, so compile for each cell */
+    S32 ref_pos[DBASE_COND_MAX_REFS];   /* offset of each SLR in rpn */
+    EV_SLR ref_base[DBASE_COND_MAX_REFS];
+    U8 rpn[EV_MAX_OUT_LEN + 1];
+}
+DBASE_COND, * P_DBASE_COND;
+
 typedef struct STACK_DBASE
 {
     EV_SLR dbase_slot;
@@ -515,6 +545,7 @@ typedef struct STACK_DBASE
     S16 cond_pos;
     EV_SLR offset;
     P_STAT_BLOCK p_stat_block;
+    P_DBASE_COND p_dbase_cond;
 }
 STACK_DBASE, * P_STACK_DBASE;
 
@@ -800,6 +831,10 @@ lookup_finish(
     P_SS_DATA p_ss_data_res,
     P_STACK_LOOKUP p_stack_lookup);
 
+extern void
+range_cache_inform(
+    _InRef_opt_ PC_EV_SLR slrp);
+
 extern void
 stat_block_init(
     P_STAT_BLOCK stbp,
@@ -1146,6 +1181,21 @@ PROC_EXEC_PROTO(c_value);
 ev_help.c external functions
 */
 
+extern void
+dbase_cond_compile(
+    _OutRef_    P_DBASE_COND p_dbase_cond,
+    P_U8 rpn_in,
+    _InRef_     PC_EV_SLR target_slrp,
+    BOOL abs_col,
+    BOOL abs_row);
+
+extern void
+dbase_cond_retarget(
+    _InoutRef_  P_DBASE_COND p_dbase_cond,
+    _InRef_     PC_EV_SLR target_slrp,
+    BOOL abs_col,
+    BOOL abs_row);
+
 _Check_return_
 extern S32
 arg_normalise(
@@ -1217,6 +1267,13 @@ array_sort(
     P_SS_DATA p_ss_data,
     _InVal_     U32 x_index);
 
+_Check_return_
+extern STATUS
+array_sort_keys(
+    P_SS_DATA p_ss_data,
+    _In_reads_(n_keys) PC_ARRAY_SORT_KEY p_array_sort_key,
+    _InVal_     U32 n_keys);
+
 extern void
 data_ensure_constant(
     P_SS_DATA p_ss_data);
@@ -1739,6 +1796,10 @@ tree_sort(
 extern void
 tree_sort_all(void);
 
+extern void
+tree_rng_itree_dispose(
+    _InoutRef_  P_SS_DOC p_ss_doc);
+
 #endif /* __evali_h */
 
 /* end of ev_evali.h */
@@ -705,6 +705,12 @@ array_range_proc_item(
     P_STAT_BLOCK p_stat_block,
     P_SS_DATA p_ss_data);
 
+_Check_return_
+static BOOL
+range_values_try(
+    P_STAT_BLOCK p_stat_block,
+    _InRef_     PC_EV_RANGE p_ev_range);
+
 static S32
 lookup_array_range_proc_array(
     P_LOOKUP_BLOCK lkbp,
@@ -715,6 +721,12 @@ lookup_array_range_proc_item(
     P_LOOKUP_BLOCK lkbp,
     P_SS_DATA p_ss_data);
 
+static BOOL
+lookup_index_try(
+    P_LOOKUP_BLOCK lkbp,
+    _InRef_     PC_EV_RANGE p_ev_range,
+    _OutRef_    P_S32 p_res);
+
 static EV_IDNO
 npv_calc(
     P_SS_DATA p_ss_data_res,
@@ -940,6 +952,386 @@ PROC_EXEC_PROTO(c_varp)
     args_array_range_proc(args, n_args, p_ss_data_res, RPN_FNV_VARP);
 }
 
+/******************************************************************************
+*
+* caches of what is learnt about large ranges
+*
+* each cache holds a few entries keyed on their range, reusing the least
+* recently used entry; an entry is dropped when a cell in its range changes
+* value, and all are dropped when the sheet is restructured
+*
+******************************************************************************/
+
+#define RANGE_CACHE_MIN_ITEMS   128 /* smaller ranges are quicker to scan */
+#define RANGE_CACHE_SIZE        4
+
+typedef struct RANGE_CACHE_ENTRY
+{
+    EV_RANGE range;
+    S32 n_items;            /* 0 if cache entry unused */
+    U32 last_used;
+}
+RANGE_CACHE_ENTRY, * P_RANGE_CACHE_ENTRY;
+
+typedef void (* P_PROC_RANGE_CACHE_DISPOSE) (
+    _InoutRef_  P_RANGE_CACHE_ENTRY p_range_cache_entry);
+
+typedef struct RANGE_CACHE
+{
+    P_ANY p_entries;        /* RANGE_CACHE_SIZE entries, each starting with a RANGE_CACHE_ENTRY */
+    U32 entry_size;
+    P_PROC_RANGE_CACHE_DISPOSE p_proc_dispose; /* frees what an entry holds beyond its RANGE_CACHE_ENTRY */
+    S32 n_used;             /* number of cache entries in use */
+    U32 use_count;
+}
+RANGE_CACHE, * P_RANGE_CACHE;
+
+#define range_cache_entry(p_range_cache, ix) \
+    PtrAddBytes(P_RANGE_CACHE_ENTRY, (p_range_cache)->p_entries, (ix) * (p_range_cache)->entry_size)
+
+static void
+range_cache_dispose(
+    _InoutRef_  P_RANGE_CACHE p_range_cache,
+    _InoutRef_  P_RANGE_CACHE_ENTRY p_range_cache_entry)
+{
+    if(0 == p_range_cache_entry->n_items)
+        return;
+
+    (* p_range_cache->p_proc_dispose) (p_range_cache_entry);
+
+    p_range_cache_entry->n_items = 0;
+
+    --p_range_cache->n_used;
+}
+
+/******************************************************************************
+*
+* find the cache entry for a range, reusing the least recently used
+* entry if it isn't there
+*
+* --out--
+* NULL if the range is not worth caching
+* *p_found FALSE if the entry has been reused and must be filled in
+*
+******************************************************************************/
+
+_Check_return_
+_Ret_maybenull_
+static P_RANGE_CACHE_ENTRY
+range_cache_find(
+    _InoutRef_  P_RANGE_CACHE p_range_cache,
+    _InRef_     PC_EV_RANGE p_ev_range,
+    _OutRef_    P_BOOL p_found)
+{
+    const S32 n_cols = ev_slr_col(&p_ev_range->e) - ev_slr_col(&p_ev_range->s);
+    const S32 n_rows = ev_slr_row(&p_ev_range->e) - ev_slr_row(&p_ev_range->s);
+    P_RANGE_CACHE_ENTRY p_range_cache_entry = NULL;
+    S32 ix;
+
+    *p_found = FALSE;
+
+    if((p_ev_range->s.flags & SLR_EXT_REF) && ev_doc_error(ev_slr_docno(&p_ev_range->s)))
+        return(NULL);
+
+    if((n_cols <= 0) || (n_rows <= 0) || (n_rows > S32_MAX / n_cols))
+        return(NULL);
+
+    if(n_cols * n_rows < RANGE_CACHE_MIN_ITEMS)
+        return(NULL);
+
+    for(ix = 0; ix < RANGE_CACHE_SIZE; ++ix)
+    {
+        P_RANGE_CACHE_ENTRY p_cached = range_cache_entry(p_range_cache, ix);
+
+        if( (0 != p_cached->n_items) &&
+            (ev_slr_docno(&p_cached->range.s) == ev_slr_docno(&p_ev_range->s)) &&
+            (ev_slr_col(&p_cached->range.s) == ev_slr_col(&p_ev_range->s)) &&
+            (ev_slr_row(&p_cached->range.s) == ev_slr_row(&p_ev_range->s)) &&
+            (ev_slr_col(&p_cached->range.e) == ev_slr_col(&p_ev_range->e)) &&
+            (ev_slr_row(&p_cached->range.e) == ev_slr_row(&p_ev_range->e)) )
+        {
+            p_cached->last_used = ++p_range_cache->use_count;
+            *p_found = TRUE;
+            return(p_cached);
+        }
+
+        /* note an empty or least recently used entry to reuse */
+        if( (NULL == p_range_cache_entry) ||
+            ((0 != p_range_cache_entry->n_items) && ((0 == p_cached->n_items) || (p_cached->last_used < p_range_cache_entry->last_used))) )
+            p_range_cache_entry = p_cached;
+    }
+
+    range_cache_dispose(p_range_cache, p_range_cache_entry);
+
+    p_range_cache_entry->range = *p_ev_range;
+    p_range_cache_entry->n_items = n_cols * n_rows;
+    p_range_cache_entry->last_used = ++p_range_cache->use_count;
+    ++p_range_cache->n_used;
+
+    return(p_range_cache_entry);
+}
+
+/******************************************************************************
+*
+* a cell has changed: drop the entries of any range containing it
+*
+* --in--
+* slrp == NULL drops all
+*
+******************************************************************************/
+
+static void
+range_cache_forget(
+    _InoutRef_  P_RANGE_CACHE p_range_cache,
+    _InRef_opt_ PC_EV_SLR slrp)
+{
+    S32 ix;
+
+    if(0 == p_range_cache->n_used)
+        return;
+
+    for(ix = 0; ix < RANGE_CACHE_SIZE; ++ix)
+    {
+        P_RANGE_CACHE_ENTRY p_range_cache_entry = range_cache_entry(p_range_cache, ix);
+
+        if(0 == p_range_cache_entry->n_items)
+            continue;
+
+        if( (NULL == slrp) ||
+            ( (ev_slr_docno(slrp) == ev_slr_docno(&p_range_cache_entry->range.s)) &&
+              (ev_slr_col(slrp) >= ev_slr_col(&p_range_cache_entry->range.s)) &&
+              (ev_slr_col(slrp) <  ev_slr_col(&p_range_cache_entry->range.e)) &&
+              (ev_slr_row(slrp) >= ev_slr_row(&p_range_cache_entry->range.s)) &&
+              (ev_slr_row(slrp) <  ev_slr_row(&p_range_cache_entry->range.e)) ) )
+            range_cache_dispose(p_range_cache, p_range_cache_entry);
+    }
+}
+
+/******************************************************************************
+*
+* numeric values of large ranges for the statistical functions
+*
+* the numbers in each summed range are gathered on first use into one
+* contiguous vector, in range scan order, and cached until a cell in the
+* range changes or the sheet is restructured; later SUM/AVG/STD/VAR of
+* the range run down the vector rather than dereferencing each cell.
+* values are accumulated in the same order as the scan so that results
+* are identical to the last bit
+*
+******************************************************************************/
+
+#define RANGE_VALUES_TYPES (EM_REA | EM_ARY | EM_BLK | EM_DAT | EM_INT) /* as array_range_proc() */
+
+typedef struct RANGE_VALUES
+{
+    RANGE_CACHE_ENTRY entry; /* must be first */
+    S32 n_values;           /* numbers found in range */
+    BOOL has_integers;      /* SUM/AVG must go the integer route */
+    BOOL uncacheable;       /* range holds dates or arrays; don't try again */
+    P_F64 p_values;         /* one per number, in range scan order */
+}
+RANGE_VALUES, * P_RANGE_VALUES;
+
+static RANGE_VALUES range_values_entries[RANGE_CACHE_SIZE];
+
+static void
+range_values_dispose(
+    _InoutRef_  P_RANGE_CACHE_ENTRY p_range_cache_entry)
+{
+    const P_RANGE_VALUES p_range_values = (P_RANGE_VALUES) p_range_cache_entry;
+
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&p_range_values->p_values));
+    p_range_values->n_values = 0;
+    p_range_values->has_integers = FALSE;
+    p_range_values->uncacheable = FALSE;
+}
+
+static RANGE_CACHE range_values_cache = { range_values_entries, sizeof32(RANGE_VALUES), range_values_dispose, 0, 0 };
+
+/******************************************************************************
+*
+* gather the numbers in a range
+*
+******************************************************************************/
+
+static void
+range_values_build(
+    _InoutRef_  P_RANGE_VALUES p_range_values)
+{
+    RANGE_SCAN_BLOCK rsb;
+    SS_DATA element;
+    STATUS status;
+
+    if(NULL == (p_range_values->p_values = al_ptr_alloc_elem(F64, p_range_values->entry.n_items, &status)))
+    {
+        p_range_values->uncacheable = TRUE;
+        return;
+    }
+
+    if(range_scan_init(&p_range_values->entry.range, &rsb) < 0)
+    {
+        p_range_values->uncacheable = TRUE;
+        return;
+    }
+
+    while(range_scan_element(&rsb, &element, RANGE_VALUES_TYPES) != RPN_FRM_END)
+    {
+        switch(ss_data_get_data_id(&element))
+        {
+        case DATA_ID_REAL:
+            p_range_values->p_values[p_range_values->n_values++] = ss_data_get_real(&element);
+            break;
+
+        case DATA_ID_LOGICAL:
+        case DATA_ID_WORD16:
+        case DATA_ID_WORD32:
+            p_range_values->p_values[p_range_values->n_values++] = (F64) ss_data_get_integer(&element);
+            p_range_values->has_integers = TRUE;
+            break;
+
+        case DATA_ID_DATE:
+        case RPN_TMP_ARRAY:
+        case RPN_RES_ARRAY:
+            /* remember not to try this range again until it changes */
+            al_ptr_dispose(P_P_ANY_PEDANTIC(&p_range_values->p_values));
+            p_range_values->n_values = 0;
+            p_range_values->uncacheable = TRUE;
+            return;
+
+        default: /* blanks, strings and errors don't add to these functions */
+            break;
+        }
+    }
+
+    trace_2(TRACE_MODULE_EVAL, "range_values_build found %d numbers in %d items", p_range_values->n_values, p_range_values->entry.n_items);
+}
+
+/******************************************************************************
+*
+* find or build the numeric values for a range
+*
+******************************************************************************/
+
+_Check_return_
+_Ret_maybenull_
+static P_RANGE_VALUES
+range_values_ensure(
+    _InRef_     PC_EV_RANGE p_ev_range)
+{
+    P_RANGE_VALUES p_range_values;
+    BOOL found;
+
+    if(NULL == (p_range_values = (P_RANGE_VALUES) range_cache_find(&range_values_cache, p_ev_range, &found)))
+        return(NULL);
+
+    if(!found)
+        range_values_build(p_range_values);
+
+    return(p_range_values->uncacheable ? NULL : p_range_values);
+}
+
+/******************************************************************************
+*
+* accumulate a range for the statistical functions from its cached values
+*
+* --out--
+* FALSE if the range must be scanned
+*
+******************************************************************************/
+
+_Check_return_
+static BOOL
+range_values_try(
+    P_STAT_BLOCK p_stat_block,
+    _InRef_     PC_EV_RANGE p_ev_range)
+{
+    P_RANGE_VALUES p_range_values;
+    PC_F64 p_values;
+    S32 n_values, i;
+
+    switch(p_stat_block->exec_array_range_id)
+    {
+    case ARRAY_RANGE_SUM:
+    case ARRAY_RANGE_AVERAGE:
+        /* running total must already be real, or about to become so */
+        if((0 != p_stat_block->count) && (DATA_ID_REAL != ss_data_get_data_id(&p_stat_block->running_data)))
+            return(FALSE);
+        break;
+
+    case ARRAY_RANGE_STD:
+    case ARRAY_RANGE_STDP:
+    case ARRAY_RANGE_VAR:
+    case ARRAY_RANGE_VARP:
+        break;
+
+    default:
+        return(FALSE);
+    }
+
+    if(NULL == (p_range_values = range_values_ensure(p_ev_range)))
+        return(FALSE);
+
+    p_values = p_range_values->p_values;
+    n_values = p_range_values->n_values;
+
+    if(0 == n_values)
+        return(TRUE);
+
+    switch(p_stat_block->exec_array_range_id)
+    {
+    case ARRAY_RANGE_SUM:
+    case ARRAY_RANGE_AVERAGE:
+        {
+        F64 sum;
+
+        /* integers are summed as integers until they get too big */
+        if(p_range_values->has_integers)
+            return(FALSE);
+
+        if(0 == p_stat_block->count)
+            sum = p_values[0];
+        else
+            sum = ss_data_get_real(&p_stat_block->running_data) + p_values[0];
+
+        for(i = 1; i < n_values; ++i)
+            sum += p_values[i];
+
+        ss_data_set_real(&p_stat_block->running_data, sum);
+        break;
+        }
+
+    default:
+        {
+        F64 sum, sum_x2;
+
+        if(0 == p_stat_block->count)
+        {
+            sum = p_values[0];
+            sum_x2 = p_values[0] * p_values[0];
+        }
+        else
+        {
+            sum = ss_data_get_real(&p_stat_block->running_data) + p_values[0];
+            sum_x2 = p_stat_block->sum_x2 + p_values[0] * p_values[0];
+        }
+
+        for(i = 1; i < n_values; ++i)
+        {
+            sum += p_values[i];
+            sum_x2 += p_values[i] * p_values[i];
+        }
+
+        p_stat_block->running_data.arg.fp = sum;
+        p_stat_block->sum_x2 = sum_x2;
+        break;
+        }
+    }
+
+    p_stat_block->count   += n_values;
+    p_stat_block->count_a += n_values;
+    return(TRUE);
+}
+
 /******************************************************************************
 *
 * process the arguments of the statistical functions
@@ -986,11 +1378,14 @@ array_range_proc(
         {
         RANGE_SCAN_BLOCK rsb;
 
+        if(range_values_try(p_stat_block, &p_ss_data->arg.range))
+            break;
+
         if(range_scan_init(&p_ss_data->arg.range, &rsb) >= 0)
         {
             SS_DATA element;
 
-            while(range_scan_element(&rsb, &element, EM_REA | EM_ARY | EM_BLK | EM_DAT | EM_INT) != RPN_FRM_END)
+            while(range_scan_element(&rsb, &element, RANGE_VALUES_TYPES) != RPN_FRM_END)
             {
                 switch(element.data_id)
                 {
@@ -1696,6 +2091,542 @@ dbase_sub_function_finish(
     array_range_proc_finish(p_ss_data, p_stack_dbase->p_stat_block);
 }
 
+/******************************************************************************
+*
+* lookups into large ranges
+*
+* what we learn about each looked-up range is cached until a cell in the
+* range changes or the sheet is restructured: a hash index for exact-match
+* lookups, built on first use, and whether the range is in order, found
+* on the first approximate-match lookup; these only narrow the search,
+* the result is always decided by ss_data_compare() as the scan would
+*
+******************************************************************************/
+
+#define LOOKUP_INDEX_TYPES (EM_REA | EM_STR | EM_DAT | EM_ARY | EM_BLK | EM_INT) /* as lookup_array_range_proc() */
+
+typedef struct LOOKUP_INDEX_ENTRY
+{
+    U32 hash;
+    S32 next;               /* next item in same bucket, ascending; -1 at end */
+}
+LOOKUP_INDEX_ENTRY, * P_LOOKUP_INDEX_ENTRY;
+
+typedef struct LOOKUP_INDEX
+{
+    RANGE_CACHE_ENTRY entry; /* must be first */
+    S32 order;              /* LOOKUP_ORDER_xxx bits */
+    BOOL unindexable;       /* range holds arrays; don't try again */
+    U32 bucket_mask;
+    P_S32 p_buckets;        /* first item in bucket; -1 if empty; NULL if not built */
+    P_LOOKUP_INDEX_ENTRY p_entries; /* one per item, in range scan order */
+}
+LOOKUP_INDEX, * P_LOOKUP_INDEX;
+
+#define LOOKUP_ORDER_KNOWN      1
+#define LOOKUP_ORDER_ASCENDING  2   /* each item <= the next */
+#define LOOKUP_ORDER_DESCENDING 4   /* each item >= the next */
+
+static LOOKUP_INDEX lookup_index_entries[RANGE_CACHE_SIZE];
+
+static void
+lookup_index_dispose(
+    _InoutRef_  P_RANGE_CACHE_ENTRY p_range_cache_entry)
+{
+    const P_LOOKUP_INDEX p_lookup_index = (P_LOOKUP_INDEX) p_range_cache_entry;
+
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&p_lookup_index->p_buckets));
+    p_lookup_index->p_entries = NULL;
+    p_lookup_index->order = 0;
+    p_lookup_index->unindexable = FALSE;
+}
+
+static RANGE_CACHE lookup_index_cache = { lookup_index_entries, sizeof32(LOOKUP_INDEX), lookup_index_dispose, 0, 0 };
+
+/* read an item as range_scan_element() would have done */
+
+static void
+lookup_index_item(
+    _OutRef_    P_SS_DATA p_ss_data,
+    _InRef_     PC_EV_RANGE p_ev_range,
+    _InVal_     S32 item)
+{
+    const EV_COL n_cols = ev_slr_col(&p_ev_range->e) - ev_slr_col(&p_ev_range->s);
+    EV_SLR slr = p_ev_range->s;
+
+    slr.col += (EV_COL) (item % n_cols);
+    slr.row += (EV_ROW) (item / n_cols);
+
+    (void) ev_slr_deref(p_ss_data, &slr, FALSE);
+    (void) arg_normalise(p_ss_data, LOOKUP_INDEX_TYPES, NULL, NULL);
+}
+
+static void
+lookup_index_slr(
+    _OutRef_    P_EV_SLR p_ev_slr,
+    _InRef_     PC_EV_RANGE p_ev_range,
+    _InVal_     S32 item)
+{
+    const EV_COL n_cols = ev_slr_col(&p_ev_range->e) - ev_slr_col(&p_ev_range->s);
+
+    *p_ev_slr = p_ev_range->s;
+    p_ev_slr->col += (EV_COL) (item % n_cols);
+    p_ev_slr->row += (EV_ROW) (item / n_cols);
+}
+
+/******************************************************************************
+*
+* hash a data item such that items which ss_data_compare() finds equal
+* hash equal: numbers, blanks and blank strings all hash as reals, and
+* strings hash upper-cased without spaces or highlights
+*
+* --out--
+* FALSE if the item can't be hashed
+*
+******************************************************************************/
+
+#define lookup_index_hash_byte(hash, byte) \
+    (((hash) ^ (U8) (byte)) * 16777619U) /* FNV-1a */
+
+static U32
+lookup_index_hash_bytes(
+    U32 hash,
+    _In_reads_bytes_(n_bytes) PC_ANY p_any,
+    _InVal_     U32 n_bytes)
+{
+    PC_U8 p_u8 = (PC_U8) p_any;
+    U32 i;
+
+    for(i = 0; i < n_bytes; ++i)
+        hash = lookup_index_hash_byte(hash, p_u8[i]);
+
+    return(hash);
+}
+
+static BOOL
+lookup_index_hash(
+    _InRef_     PC_SS_DATA p_ss_data,
+    _OutRef_    P_U32 p_hash)
+{
+    U32 hash = 2166136261U;
+    F64 f64;
+
+    switch(ss_data_get_data_id(p_ss_data))
+    {
+    case DATA_ID_REAL:
+        f64 = ss_data_get_real(p_ss_data);
+        break;
+
+    case DATA_ID_LOGICAL:
+    case DATA_ID_WORD16:
+    case DATA_ID_WORD32:
+        f64 = (F64) ss_data_get_integer(p_ss_data);
+        break;
+
+    case DATA_ID_BLANK:
+        f64 = 0.0;
+        break;
+
+    case RPN_DAT_STRING:
+    case RPN_TMP_STRING:
+    case RPN_RES_STRING:
+        {
+        PC_U8 p_u8 = ss_data_get_string(p_ss_data);
+        U32 len = ss_data_get_string_size(p_ss_data);
+        U32 i;
+
+        if(ss_string_is_blank(p_ss_data))
+        {
+            f64 = 0.0;
+            break;
+        }
+
+        hash = lookup_index_hash_byte(hash, RPN_DAT_STRING);
+
+        for(i = 0; (i < len) && (CH_NULL != p_u8[i]); ++i)
+        {
+            const U8 u8 = p_u8[i];
+
+            if((u8 <= CH_SPACE) && (CH_NULL != u8))
+                continue; /* stricmp_wild() ignores highlights and leading/trailing spaces */
+
+            hash = lookup_index_hash_byte(hash, toupper(u8));
+        }
+
+        *p_hash = hash;
+        return(TRUE);
+        }
+
+    case DATA_ID_DATE:
+        hash = lookup_index_hash_byte(hash, DATA_ID_DATE);
+        hash = lookup_index_hash_bytes(hash, &p_ss_data->arg.ss_date.date, sizeof32(p_ss_data->arg.ss_date.date));
+        hash = lookup_index_hash_bytes(hash, &p_ss_data->arg.ss_date.time, sizeof32(p_ss_data->arg.ss_date.time));
+        *p_hash = hash;
+        return(TRUE);
+
+    case DATA_ID_ERROR:
+        {
+        const S32 status = p_ss_data->arg.ss_error.status;
+        hash = lookup_index_hash_byte(hash, DATA_ID_ERROR);
+        hash = lookup_index_hash_bytes(hash, &status, sizeof32(status));
+        *p_hash = hash;
+        return(TRUE);
+        }
+
+    default:
+        return(FALSE);
+    }
+
+    hash = lookup_index_hash_byte(hash, DATA_ID_REAL);
+
+    if(isnan(f64))
+    {   /* ss_data_compare() finds any two NaNs equal, whatever their payload */
+        *p_hash = hash;
+        return(TRUE);
+    }
+
+    if(f64 == 0.0)
+        f64 = 0.0; /* -0.0 compares equal to 0.0 */
+
+    *p_hash = lookup_index_hash_bytes(hash, &f64, sizeof32(f64));
+    return(TRUE);
+}
+
+/******************************************************************************
+*
+* does a string contain wildcards?
+*
+******************************************************************************/
+
+_Check_return_
+static BOOL
+lookup_index_wild(
+    _InRef_     PC_SS_DATA p_ss_data)
+{
+    PC_U8 p_u8;
+    U32 len, i;
+
+    if(!ss_data_is_string(p_ss_data))
+        return(FALSE);
+
+    p_u8 = ss_data_get_string(p_ss_data);
+    len = ss_data_get_string_size(p_ss_data);
+
+    for(i = 0; (i < len) && (CH_NULL != p_u8[i]); ++i)
+        if(CH_CIRCUMFLEX_ACCENT == p_u8[i])
+            return(TRUE);
+
+    return(FALSE);
+}
+
+/******************************************************************************
+*
+* build the hash index for a range
+*
+******************************************************************************/
+
+_Check_return_
+static BOOL
+lookup_index_build(
+    _InoutRef_  P_LOOKUP_INDEX p_lookup_index)
+{
+    U32 n_buckets;
+    S32 item, ix;
+    STATUS status;
+
+    if(NULL != p_lookup_index->p_buckets)
+        return(TRUE);
+
+    if(p_lookup_index->unindexable)
+        return(FALSE);
+
+    for(n_buckets = RANGE_CACHE_MIN_ITEMS; n_buckets < (U32) p_lookup_index->entry.n_items; n_buckets <<= 1)
+        if(n_buckets >= (1U << 24))
+            break;
+
+    if(NULL == (p_lookup_index->p_buckets = al_ptr_alloc_bytes(P_S32, n_buckets * sizeof32(S32) + p_lookup_index->entry.n_items * sizeof32(LOOKUP_INDEX_ENTRY), &status)))
+        return(FALSE);
+
+    p_lookup_index->p_entries = (P_LOOKUP_INDEX_ENTRY) (p_lookup_index->p_buckets + n_buckets);
+    p_lookup_index->bucket_mask = n_buckets - 1;
+
+    for(item = 0; item < p_lookup_index->entry.n_items; ++item)
+    {
+        SS_DATA element;
+        BOOL hashed;
+
+        lookup_index_item(&element, &p_lookup_index->entry.range, item);
+        hashed = lookup_index_hash(&element, &p_lookup_index->p_entries[item].hash);
+        ss_data_free_resources(&element);
+
+        if(!hashed)
+        {   /* remember not to try this range again until it changes */
+            al_ptr_dispose(P_P_ANY_PEDANTIC(&p_lookup_index->p_buckets));
+            p_lookup_index->p_entries = NULL;
+            p_lookup_index->unindexable = TRUE;
+            return(FALSE);
+        }
+    }
+
+    /* chain items backwards so that each bucket lists its items in range scan order */
+    for(ix = 0; ix < (S32) n_buckets; ++ix)
+        p_lookup_index->p_buckets[ix] = -1;
+
+    for(item = p_lookup_index->entry.n_items - 1; item >= 0; --item)
+    {
+        const U32 bucket = p_lookup_index->p_entries[item].hash & p_lookup_index->bucket_mask;
+
+        p_lookup_index->p_entries[item].next = p_lookup_index->p_buckets[bucket];
+        p_lookup_index->p_buckets[bucket] = item;
+    }
+
+    trace_2(TRACE_MODULE_EVAL, "lookup_index_build built index of %d items, %u buckets", p_lookup_index->entry.n_items, n_buckets);
+    return(TRUE);
+}
+
+/******************************************************************************
+*
+* find out whether a range is in order
+*
+******************************************************************************/
+
+static S32
+lookup_index_order(
+    _InoutRef_  P_LOOKUP_INDEX p_lookup_index)
+{
+    SS_DATA element[2];
+    S32 order = LOOKUP_ORDER_ASCENDING | LOOKUP_ORDER_DESCENDING;
+    S32 item;
+
+    if(p_lookup_index->order & LOOKUP_ORDER_KNOWN)
+        return(p_lookup_index->order);
+
+    lookup_index_item(&element[0], &p_lookup_index->entry.range, 0);
+
+    for(item = 1; (item < p_lookup_index->entry.n_items) && (0 != order); ++item)
+    {
+        SS_DATA * const p_prev = &element[(item - 1) & 1];
+        SS_DATA * const p_this = &element[item & 1];
+        S32 res;
+
+        lookup_index_item(p_this, &p_lookup_index->entry.range, item);
+
+        if(ss_data_is_array(p_prev) || ss_data_is_array(p_this))
+            order = 0; /* the scan would look inside these */
+        else if(lookup_index_wild(p_this))
+            order = 0; /* would be compared as a pattern */
+        else if((res = ss_data_compare(p_prev, p_this)) < 0)
+            order &= ~LOOKUP_ORDER_DESCENDING;
+        else if(res > 0)
+            order &= ~LOOKUP_ORDER_ASCENDING;
+
+        ss_data_free_resources(p_prev);
+    }
+
+    ss_data_free_resources(&element[(item - 1) & 1]);
+
+    p_lookup_index->order = order | LOOKUP_ORDER_KNOWN;
+
+    trace_1(TRACE_MODULE_EVAL, "lookup_index_order found order %d", p_lookup_index->order);
+    return(p_lookup_index->order);
+}
+
+/******************************************************************************
+*
+* do an exact-match lookup in a range using its hash index
+*
+******************************************************************************/
+
+static S32
+lookup_index_exact(
+    P_LOOKUP_BLOCK lkbp,
+    _InRef_     P_LOOKUP_INDEX p_lookup_index,
+    _InVal_     U32 hash,
+    _OutRef_    P_S32 p_res)
+{
+    S32 item;
+
+    for(item = p_lookup_index->p_buckets[hash & p_lookup_index->bucket_mask]; item >= 0; item = p_lookup_index->p_entries[item].next)
+    {
+        SS_DATA element;
+        S32 match;
+
+        if(p_lookup_index->p_entries[item].hash != hash)
+            continue;
+
+        lookup_index_item(&element, &p_lookup_index->entry.range, item);
+        match = ss_data_compare(&element, &lkbp->target_data);
+        ss_data_free_resources(&element);
+
+        if(0 == match)
+            break;
+    }
+
+    /* leave the lookup block as the scan would have done */
+    if(item >= 0)
+    {
+        lkbp->count += item + 1;
+        *p_res = 1;
+    }
+    else
+    {
+        item = p_lookup_index->entry.n_items - 1;
+        lkbp->count += p_lookup_index->entry.n_items;
+        *p_res = 0;
+    }
+
+    lkbp->had_one = 1;
+    return(item);
+}
+
+/******************************************************************************
+*
+* do an approximate-match lookup in a range that is in order by binary search
+*
+* the scan stops at the first item equal to the target, or else takes the
+* item before the first one past the target; in an ordered range that is
+* the first item not before the target, or the one before that
+*
+******************************************************************************/
+
+static S32
+lookup_index_ordered(
+    P_LOOKUP_BLOCK lkbp,
+    _InRef_     P_LOOKUP_INDEX p_lookup_index,
+    _OutRef_    P_S32 p_res)
+{
+    S32 lo = 0, hi = p_lookup_index->entry.n_items;
+    S32 match = 1;
+
+    while(lo < hi)
+    {
+        const S32 mid = lo + ((hi - lo) >> 1);
+        SS_DATA element;
+        S32 res;
+
+        lookup_index_item(&element, &p_lookup_index->entry.range, mid);
+        res = ss_data_compare(&element, &lkbp->target_data);
+        ss_data_free_resources(&element);
+
+        if(lkbp->match < 0)
+            res = -res;
+
+        if(res < 0)
+            lo = mid + 1;
+        else
+        {
+            hi = mid;
+            match = res;
+        }
+    }
+
+    if((lo < p_lookup_index->entry.n_items) && (0 == match))
+    {
+        lkbp->count += lo + 1;
+        lkbp->had_one = 1;
+        *p_res = 1;
+        return(lo);
+    }
+
+    /* no items before the target: had_one stays as it was */
+    if(0 == lo)
+    {
+        *p_res = 1;
+        return(-1);
+    }
+
+    lkbp->count += lo;
+    lkbp->had_one = 1;
+    *p_res = 1;
+    return(lo - 1);
+}
+
+/******************************************************************************
+*
+* do a lookup in a range using what is cached about it
+*
+* --out--
+* FALSE if the lookup must be done by scanning the range
+*
+******************************************************************************/
+
+static BOOL
+lookup_index_try(
+    P_LOOKUP_BLOCK lkbp,
+    _InRef_     PC_EV_RANGE p_ev_range,
+    _OutRef_    P_S32 p_res)
+{
+    P_LOOKUP_INDEX p_lookup_index;
+    U32 hash;
+    S32 item;
+    BOOL found;
+
+    *p_res = 0;
+
+    switch(lkbp->lookup_id)
+    {
+    case LOOKUP_LOOKUP:
+    case LOOKUP_MATCH:
+    case LOOKUP_HLOOKUP:
+    case LOOKUP_VLOOKUP:
+        break;
+
+    default:
+        return(FALSE);
+    }
+
+    /* target must be a hashable scalar (this rejects arrays) */
+    if(!lookup_index_hash(&lkbp->target_data, &hash))
+        return(FALSE);
+
+    /* wildcards need the scan */
+    if(lookup_index_wild(&lkbp->target_data))
+        return(FALSE);
+
+    if(NULL == (p_lookup_index = (P_LOOKUP_INDEX) range_cache_find(&lookup_index_cache, p_ev_range, &found)))
+        return(FALSE);
+
+    if(0 == lkbp->match)
+    {
+        if(!lookup_index_build(p_lookup_index))
+            return(FALSE);
+
+        item = lookup_index_exact(lkbp, p_lookup_index, hash, p_res);
+    }
+    else
+    {
+        if(!(lookup_index_order(p_lookup_index) & ((lkbp->match > 0) ? LOOKUP_ORDER_ASCENDING : LOOKUP_ORDER_DESCENDING)))
+            return(FALSE);
+
+        item = lookup_index_ordered(lkbp, p_lookup_index, p_res);
+    }
+
+    if(item >= 0)
+    {
+        lookup_index_slr(&lkbp->result_data.arg.slr, p_ev_range, item);
+        lkbp->result_data.data_id = DATA_ID_SLR;
+    }
+
+    return(TRUE);
+}
+
+/******************************************************************************
+*
+* a cell has changed: forget what is cached about any range containing it
+*
+* --in--
+* slrp == NULL forgets all
+*
+******************************************************************************/
+
+extern void
+range_cache_inform(
+    _InRef_opt_ PC_EV_SLR slrp)
+{
+    range_cache_forget(&lookup_index_cache, slrp);
+    range_cache_forget(&range_values_cache, slrp);
+}
+
 /******************************************************************************
 *
 * process data for arrays and ranges for
@@ -1724,6 +2655,9 @@ lookup_array_range_proc(
 
     case DATA_ID_RANGE:
         {
+        if(!lkbp->in_range && lookup_index_try(lkbp, &p_ss_data->arg.range, &res))
+            break;
+
         if(lkbp->in_range || range_scan_init(&p_ss_data->arg.range, &lkbp->rsb) >= 0)
         {
             SS_DATA element;
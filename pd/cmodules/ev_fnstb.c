@@ -307,6 +307,200 @@ PROC_EXEC_PROTO(c_small)
 
 #endif
 
+/******************************************************************************
+*
+* select the k-th smallest of n numbers without sorting them all:
+* leaves it at p_f64[k], with no larger ones before it and no smaller ones after
+*
+* quickselect on a median-of-three pivot; should that make poor progress
+* (more than 2 log2(n) rounds) just sort what remains
+*
+******************************************************************************/
+
+PROC_QSORT_PROTO(static, proc_qsort_f64, F64)
+{
+    QSORT_ARG1_VAR_DECL(PC_F64, p_f64_1);
+    QSORT_ARG2_VAR_DECL(PC_F64, p_f64_2);
+
+    if(*p_f64_1 < *p_f64_2)
+        return(-1);
+
+    if(*p_f64_1 > *p_f64_2)
+        return(1);
+
+    return(0);
+}
+
+static inline void
+f64_swap(
+    _InoutRef_  P_F64 p_f64_1,
+    _InoutRef_  P_F64 p_f64_2)
+{
+    const F64 temp = *p_f64_1;
+    *p_f64_1 = *p_f64_2;
+    *p_f64_2 = temp;
+}
+
+static void
+f64_select(
+    _Inout_updates_(n) P_F64 p_f64,
+    _InVal_     S32 n,
+    _InVal_     S32 k)
+{
+    S32 lo = 0;
+    S32 hi = n - 1;
+    S32 rounds_left = 0;
+    S32 i;
+
+    for(i = n; i > 1; i >>= 1)
+        rounds_left += 2;
+
+    while(hi > lo)
+    {
+        S32 mid, l, r;
+        F64 pivot;
+
+        if(0 == rounds_left--)
+        {
+            qsort(p_f64 + lo, (size_t) (hi - lo + 1), sizeof32(F64), proc_qsort_f64);
+            return;
+        }
+
+        /* order lo, mid, hi and take the middle one as pivot */
+        mid = lo + ((hi - lo) >> 1);
+
+        if(p_f64[mid] < p_f64[lo])
+            f64_swap(&p_f64[mid], &p_f64[lo]);
+        if(p_f64[hi] < p_f64[lo])
+            f64_swap(&p_f64[hi], &p_f64[lo]);
+        if(p_f64[hi] < p_f64[mid])
+            f64_swap(&p_f64[hi], &p_f64[mid]);
+
+        pivot = p_f64[mid];
+
+        /* partition: [lo..r] <= pivot <= [l..hi] */
+        l = lo;
+        r = hi;
+
+        while(l <= r)
+        {
+            while(p_f64[l] < pivot)
+                ++l;
+
+            while(p_f64[r] > pivot)
+                --r;
+
+            if(l <= r)
+            {
+                f64_swap(&p_f64[l], &p_f64[r]);
+                ++l;
+                --r;
+            }
+        }
+
+        if(k <= r)
+            hi = r;
+        else if(k >= l)
+            lo = l;
+        else
+            return; /* k is amongst those equal to the pivot */
+    }
+}
+
+/* MEDIAN of just numbers can be found by selection; anything else (whose sort order
+ * is then by type) is left to the full sort below
+ */
+
+_Check_return_
+static BOOL
+median_select(
+    _InRef_     PC_SS_DATA p_ss_data_in,
+    _OutRef_    P_SS_DATA p_ss_data_out)
+{
+    STATUS status = STATUS_OK;
+    S32 x_size, y_size, n, ix, iy;
+    S32 y_half;
+    P_F64 p_f64;
+    F64 median;
+
+    switch(ss_data_get_data_id(p_ss_data_in))
+    {
+    case DATA_ID_RANGE:
+    case RPN_TMP_ARRAY:
+    case RPN_RES_ARRAY:
+        break;
+
+    default:
+        return(FALSE);
+    }
+
+    array_range_sizes(p_ss_data_in, &x_size, &y_size);
+
+    n = x_size * y_size;
+
+    if(0 == n)
+        return(FALSE);
+
+    if(NULL == (p_f64 = al_ptr_alloc_elem(F64, n, &status)))
+        return(FALSE);
+
+    for(iy = 0; iy < y_size; ++iy)
+    {
+        for(ix = 0; ix < x_size; ++ix)
+        {
+            SS_DATA ss_data;
+
+            switch(array_range_index(&ss_data, p_ss_data_in, ix, iy, EM_CONST))
+            {
+            case DATA_ID_REAL:
+                if(isnan(ss_data_get_real(&ss_data)))
+                    break;
+                p_f64[iy * x_size + ix] = ss_data_get_real(&ss_data);
+                continue;
+
+            case DATA_ID_WORD16:
+            case DATA_ID_WORD32:
+                p_f64[iy * x_size + ix] = (F64) ss_data_get_integer(&ss_data);
+                continue;
+
+            default:
+                ss_data_free_resources(&ss_data);
+                break;
+            }
+
+            al_ptr_dispose(P_P_ANY_PEDANTIC(&p_f64));
+            return(FALSE);
+        }
+    }
+
+    y_half = n / 2;
+
+    f64_select(p_f64, n, y_half);
+
+    median = p_f64[y_half];
+
+    if(0 == (n & 1))
+    {
+        /* if there are an even number of elements, the median is the mean of the two middle ones;
+         * the lower of those is the largest of the ones selection left below
+         */
+        F64 lower = p_f64[0];
+        S32 i;
+
+        for(i = 1; i < y_half; ++i)
+            if(lower < p_f64[i])
+                lower = p_f64[i];
+
+        median = (median + lower) / 2.0;
+    }
+
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&p_f64));
+
+    ss_data_set_real_try_integer(p_ss_data_out, median);
+
+    return(TRUE);
+}
+
 /******************************************************************************
 *
 * NUMBER median(array)
@@ -320,6 +514,9 @@ PROC_EXEC_PROTO(c_median)
 
     exec_func_ignore_parms();
 
+    if(median_select(args[0], p_ss_data_res))
+        return;
+
     ss_data_set_blank(&ss_data_temp_array);
 
     for(;;)
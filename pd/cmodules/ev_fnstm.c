@@ -15,7 +15,7 @@
 
 #include "cmodules/ev_evali.h"
 
-#include "cmodules/mathxtr2.h" /* for linest() */
+#include "cmodules/mathxtr2.h" /* for linest_accumulator_xxx() */
 
 /******************************************************************************
 *
@@ -237,53 +237,6 @@ PROC_EXEC_PROTO(c_growth)
 *
 ******************************************************************************/
 
-typedef struct FOR_FIRST_LINEST
-{
-    PC_F64 x; /* const */
-    S32 x_vars;
-    PC_F64 y; /* const */
-    P_F64 a;
-}
-FOR_FIRST_LINEST, * P_FOR_FIRST_LINEST;
-
-PROC_LINEST_DATA_GET_PROTO(static, ligp, client_handle, colID, row)
-{
-    P_FOR_FIRST_LINEST lidatap = (P_FOR_FIRST_LINEST) client_handle;
-
-    switch(colID)
-    {
-    case LINEST_A_COLOFF:
-        assert0();
-        return(0.0);
-
-    case LINEST_Y_COLOFF:
-        return(lidatap->y[row]);
-
-    default:
-        {
-        S32 coloff = colID - LINEST_X_COLOFF;
-        return((lidatap->x + row * lidatap->x_vars) [coloff]);
-        }
-    }
-}
-
-PROC_LINEST_DATA_PUT_PROTO(static, lipp, client_handle, colID, row, value)
-{
-    P_FOR_FIRST_LINEST lidatap = (P_FOR_FIRST_LINEST) client_handle;
-
-    switch(colID)
-    {
-    case LINEST_A_COLOFF:
-        lidatap->a[row] = value;
-        break;
-
-    default: default_unhandled();
-        break;
-    }
-
-    return(STATUS_DONE);
-}
-
 typedef struct LINEST_ARRAY
 {
     P_F64 val;
@@ -306,7 +259,7 @@ PROC_EXEC_PROTO(c_linest)
     S32 y_items;
     S32 x_vars;
     STATUS status = STATUS_OK;
-    FOR_FIRST_LINEST lidata;
+    LINEST_ACCUMULATOR linest_accumulator;
 
     exec_func_ignore_parms();
 
@@ -318,6 +271,8 @@ PROC_EXEC_PROTO(c_linest)
     known_e  = empty;
     result_a = empty;
 
+    linest_accumulator.M = NULL;
+
     switch(n_args)
     {
     default:
@@ -363,10 +318,9 @@ PROC_EXEC_PROTO(c_linest)
     else
         x_vars = (data_in_cols) ? known_x.cols : known_x.rows;
 
-    /* simple to allocate y and x arrays together */
-    if(NULL == (known_y.val = al_ptr_alloc_elem(F64, (U32) y_items * ((U32) x_vars + 1), &status)))
+    /* no copies of the y and x data are made - each data point goes straight into the sums */
+    if(status_fail(status = linest_accumulator_init(&linest_accumulator, (U32) x_vars)))
         goto endlabel;
-    known_x.val = &known_y.val[y_items];
 
     result_a.cols = x_vars + 1;
     result_a.rows = stats ? 3 : 1;
@@ -380,9 +334,6 @@ PROC_EXEC_PROTO(c_linest)
             status = EVAL_ERR_MISMATCHED_MATRICES;
             goto endlabel;
         }
-
-        if(NULL == (known_a.val = al_ptr_alloc_elem(F64, result_a.cols, &status)))
-            goto endlabel;
     }
 
     if(known_e.rows != 0)
@@ -393,9 +344,6 @@ PROC_EXEC_PROTO(c_linest)
             status = EVAL_ERR_MISMATCHED_MATRICES;
             goto endlabel;
         }
-
-        if(NULL == (known_e.val = al_ptr_alloc_elem(F64, y_items, &status)))
-            goto endlabel;
     }
 
     if(status_ok(ss_array_make(p_ss_data_res, result_a.cols, result_a.rows)))
@@ -403,9 +351,11 @@ PROC_EXEC_PROTO(c_linest)
         S32 i, j;
         SS_DATA ss_data;
 
-        /* copy y data into working array */
         for(i = 0; i < y_items; ++i)
         {
+            F64 y;
+
+            /* y data */
             if(DATA_ID_REAL !=
                 array_range_index(&ss_data, args[0],
                                   (data_in_cols) ? 0 : i,
@@ -416,12 +366,9 @@ PROC_EXEC_PROTO(c_linest)
                 goto endlabel;
             }
 
-            known_y.val[i] = ss_data_get_real(&ss_data);
-        }
+            y = ss_data_get_real(&ss_data);
 
-        /* copy x data into working array */
-        for(i = 0; i < y_items; ++i)
-        {
+            /* x data */
             if(n_args > 1)
             {
                 for(j = 0; j < x_vars; ++j)
@@ -436,57 +383,41 @@ PROC_EXEC_PROTO(c_linest)
                         goto endlabel;
                     }
 
-                    (known_x.val + i * x_vars)[j] = ss_data_get_real(&ss_data);
+                    linest_accumulator.x[j] = ss_data_get_real(&ss_data);
                 }
             }
             else
-                known_x.val[i] = (F64) i + 1.0; /* make simple { 1.0, 2.0, 3.0 ... } */
+                linest_accumulator.x[0] = (F64) i + 1.0; /* make simple { 1.0, 2.0, 3.0 ... } */
+
+            linest_accumulator_add(&linest_accumulator, linest_accumulator.x, y);
         }
 
         /* <<< ignore the a data for the mo */
-        if(known_a.val)
-        { /*EMPTY*/ }
 
-        /* copy (possibly partial) ye data into working array */
-        if(known_e.val)
+        /* check (possibly partial) ye data */
+        if(known_e.rows != 0)
         {
-            for(i = 0; i < y_items; ++i)
+            const S32 e_items = MIN(y_items, (data_in_cols) ? known_e.rows : known_e.cols);
+
+            for(i = 0; i < e_items; ++i)
             {
-                if(i < ((data_in_cols) ? known_e.rows : known_e.cols))
+                if(DATA_ID_REAL !=
+                    array_range_index(&ss_data, args[4],
+                                      (data_in_cols) ? 0 : i,
+                                      (data_in_cols) ? i : 0,
+                                      EM_REA))
                 {
-                    if(DATA_ID_REAL !=
-                        array_range_index(&ss_data, args[4],
-                                          (data_in_cols) ? 0 : i,
-                                          (data_in_cols) ? i : 0,
-                                          EM_REA))
-                    {
-                        status = EVAL_ERR_MATRIX_NOT_NUMERIC;
-                        goto endlabel;
-                    }
-
-                    known_e.val[i] = ss_data_get_real(&ss_data);
+                    status = EVAL_ERR_MATRIX_NOT_NUMERIC;
+                    goto endlabel;
                 }
-                else
-                    known_e.val[i] = 1.0;
             }
         }
 
         /* and then ignore it! */
 
-/* bodgey bit from here ... */
-
-        lidata.x = known_x.val;
-        lidata.x_vars = x_vars;
-
-        lidata.y = known_y.val;
-
-        lidata.a = result_a.val;
-
-        if(status_fail(status = linest(ligp, lipp, (CLIENT_HANDLE) &lidata, x_vars, y_items)))
+        if(status_fail(status = linest_accumulator_solve(&linest_accumulator, result_a.val)))
             goto endlabel;
 
-/* ... to here */
-
         /* copy result a data from working array */
 
         for(j = 0; j < result_a.cols; ++j)
@@ -535,10 +466,8 @@ endlabel:;
         ss_data_set_error(p_ss_data_res, status);
     }
 
-    al_ptr_dispose(P_P_ANY_PEDANTIC(&known_e.val));
-    al_ptr_dispose(P_P_ANY_PEDANTIC(&known_a.val));
     al_ptr_dispose(P_P_ANY_PEDANTIC(&result_a.val));
-    al_ptr_dispose(P_P_ANY_PEDANTIC(&known_y.val)); /* and x too */
+    linest_accumulator_dispose(&linest_accumulator);
 }
 
 /******************************************************************************
@@ -1007,19 +1007,34 @@ PROC_EXEC_PROTO(c_set_name)
 
 /******************************************************************************
 *
-* ARRAY sort(array {, column_index})
+* ARRAY sort(array {, column_index {, descending} {, column_index, descending ...}})
+*
+* rows are ordered on the first key column, ties on the next, and so on;
+* rows that tie throughout stay in their original order
 *
 ******************************************************************************/
 
 PROC_EXEC_PROTO(c_sort)
 {
-    U32 x_index = 0;
+    ARRAY_SORT_KEY array_sort_key[ARRAY_SORT_KEYS_MAX];
+    U32 n_keys = 0;
+    S32 ix;
     STATUS status;
 
     exec_func_ignore_parms();
 
-    if(n_args > 1)
-        x_index = (U32) ss_data_get_integer(args[1]); /* array_sort() does range checking */ /* NB NOT -1 - SORT() is zero-based */
+    array_sort_key[0].x_index = 0;
+    array_sort_key[0].descending = FALSE;
+
+    for(ix = 1; ix < n_args; ix += 2)
+    {
+        array_sort_key[n_keys].x_index = (U32) ss_data_get_integer(args[ix]); /* array_sort_keys() does range checking */ /* NB NOT -1 - SORT() is zero-based */
+        array_sort_key[n_keys].descending = (ix + 1 < n_args) && (0 != ss_data_get_integer(args[ix + 1]));
+        ++n_keys;
+    }
+
+    if(0 == n_keys)
+        n_keys = 1;
 
     status_assert(ss_data_resource_copy(p_ss_data_res, args[0]));
     data_ensure_constant(p_ss_data_res);
@@ -1027,7 +1042,7 @@ PROC_EXEC_PROTO(c_sort)
     if(ss_data_is_error(p_ss_data_res))
         return;
 
-    if(status_fail(status = array_sort(p_ss_data_res, x_index)))
+    if(status_fail(status = array_sort_keys(p_ss_data_res, array_sort_key, n_keys)))
     {
         ss_data_free_resources(p_ss_data_res);
         ss_data_set_error(p_ss_data_res, status);
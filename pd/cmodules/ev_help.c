@@ -41,6 +41,15 @@ data_ensure_constant_sub(
     _InoutRef_  P_SS_DATA p_ss_data,
     _InVal_     S32 array);
 
+static S32
+proc_conditional_rpn(
+    P_U8 rpn_out,
+    P_U8 rpn_in,
+    _InRef_     PC_EV_SLR target_slrp,
+    BOOL abs_col,
+    BOOL abs_row,
+    P_DBASE_COND p_dbase_cond);
+
 /******************************************************************************
 *
 * given a data item and a set of data allowable flags,
@@ -810,51 +819,274 @@ array_scan_init(
 *
 * locals for array sorting
 *
+* rows are sorted by index, with each key column picked out once and
+* held as reals where it is all numbers, and are only moved once the
+* order is known; everything sits in the one context passed down, so
+* sorts may nest
+*
 ******************************************************************************/
 
-static U32 x_index_static;
+typedef struct ARRAY_SORT_COLUMN
+{
+    PC_SS_DATA p_ss_data_key;   /* key element of the first row */
+    U32 stride;                 /* elements from one row to the next */
+    P_F64 p_f64;                /* key column as reals if all numbers, else NULL */
+    BOOL descending;
+}
+ARRAY_SORT_COLUMN, * P_ARRAY_SORT_COLUMN; typedef const ARRAY_SORT_COLUMN * PC_ARRAY_SORT_COLUMN;
 
-PROC_QSORT_PROTO(static, proc_array_sort, SS_DATA)
+_Check_return_
+static S32
+array_sort_compare_rows(
+    _In_reads_(n_columns) PC_ARRAY_SORT_COLUMN p_array_sort_column,
+    _InVal_     U32 n_columns,
+    _InVal_     U32 row_1,
+    _InVal_     U32 row_2)
 {
-    PC_SS_DATA p_ss_data_row_1 = (PC_SS_DATA) _arg1;
-    PC_SS_DATA p_ss_data_row_2 = (PC_SS_DATA) _arg2;
+    U32 i;
 
-    PC_SS_DATA p_ss_data_1 = p_ss_data_row_1 + x_index_static;
-    PC_SS_DATA p_ss_data_2 = p_ss_data_row_2 + x_index_static;
+    for(i = 0; i < n_columns; ++i, ++p_array_sort_column)
+    {
+        S32 res;
 
-    return((int) ss_data_compare(p_ss_data_1, p_ss_data_2));
+        if(NULL != p_array_sort_column->p_f64)
+        {   /* same ordering as ss_data_compare() gives these */
+            const F64 f64_1 = p_array_sort_column->p_f64[row_1];
+            const F64 f64_2 = p_array_sort_column->p_f64[row_2];
+
+            res = (f64_1 == f64_2) ? 0 : (f64_1 < f64_2) ? -1 : 1;
+        }
+        else
+            res = ss_data_compare(p_array_sort_column->p_ss_data_key + (row_1 * p_array_sort_column->stride),
+                                  p_array_sort_column->p_ss_data_key + (row_2 * p_array_sort_column->stride));
+
+        if(0 != res)
+        {
+            if(p_array_sort_column->descending)
+                return((res > 0) ? -1 : 1);
+
+            return(res);
+        }
+    }
+
+    return(0);
+}
+
+/* bottom-up merge sort of the row indices - stable, and needs no static state */
+
+static void
+array_sort_merge(
+    _Inout_updates_(n_rows) P_U32 p_index,
+    _Out_writes_(n_rows) P_U32 p_index_temp,
+    _InVal_     U32 n_rows,
+    _In_reads_(n_columns) PC_ARRAY_SORT_COLUMN p_array_sort_column,
+    _InVal_     U32 n_columns)
+{
+    P_U32 p_from = p_index;
+    P_U32 p_to = p_index_temp;
+    U32 width;
+
+    for(width = 1; width < n_rows; width *= 2)
+    {
+        U32 lo;
+
+        for(lo = 0; lo < n_rows; lo += 2 * width)
+        {
+            const U32 mid = MIN(lo + width, n_rows);
+            const U32 hi = MIN(lo + 2 * width, n_rows);
+            U32 i = lo, j = mid, k = lo;
+
+            while((i < mid) && (j < hi))
+            {
+                /* only take from the right run when strictly less, to keep it stable */
+                if(array_sort_compare_rows(p_array_sort_column, n_columns, p_from[j], p_from[i]) < 0)
+                    p_to[k++] = p_from[j++];
+                else
+                    p_to[k++] = p_from[i++];
+            }
+
+            while(i < mid)
+                p_to[k++] = p_from[i++];
+
+            while(j < hi)
+                p_to[k++] = p_from[j++];
+        }
+
+        {
+        P_U32 p_swap = p_from;
+        p_from = p_to;
+        p_to = p_swap;
+        } /*block*/
+    }
+
+    if(p_from != p_index)
+        memcpy32(p_index, p_from, n_rows * sizeof32(*p_index));
+}
+
+/* pick out a key column as reals, provided that every element is a plain number */
+
+_Check_return_
+static STATUS
+array_sort_column_reals(
+    _InoutRef_  P_ARRAY_SORT_COLUMN p_array_sort_column,
+    _InVal_     U32 n_rows)
+{
+    STATUS status = STATUS_OK;
+    PC_SS_DATA p_ss_data = p_array_sort_column->p_ss_data_key;
+    P_F64 p_f64;
+    U32 iy;
+
+    if(NULL == (p_f64 = al_ptr_alloc_elem(F64, n_rows, &status)))
+        return(status);
+
+    for(iy = 0; iy < n_rows; ++iy, p_ss_data += p_array_sort_column->stride)
+    {
+        switch(ss_data_get_data_id(p_ss_data))
+        {
+        case DATA_ID_REAL:
+            if(isnan(ss_data_get_real(p_ss_data)))
+                break; /* leave NaNs to ss_data_compare() */
+
+            p_f64[iy] = ss_data_get_real(p_ss_data);
+            continue;
+
+        case DATA_ID_WORD16:
+        case DATA_ID_WORD32:
+            p_f64[iy] = (F64) ss_data_get_integer(p_ss_data);
+            continue;
+
+        default:
+            break;
+        }
+
+        /* some other type - compare the elements themselves */
+        al_ptr_dispose(P_P_ANY_PEDANTIC(&p_f64));
+        break;
+    }
+
+    p_array_sort_column->p_f64 = p_f64;
+    return(STATUS_OK);
 }
 
 /******************************************************************************
 *
-* sort an array
+* sort the rows of an array on one or more key columns
 *
 ******************************************************************************/
 
+_Check_return_
 extern STATUS
-array_sort(
+array_sort_keys(
     P_SS_DATA p_ss_data,
-    _InVal_     U32 x_index)
+    _In_reads_(n_keys) PC_ARRAY_SORT_KEY p_array_sort_key,
+    _InVal_     U32 n_keys)
 {
+    const U32 x_size = (U32) p_ss_data->arg.ss_array.x_size;
+    const U32 y_size = (U32) p_ss_data->arg.ss_array.y_size;
     STATUS status = STATUS_OK;
+    ARRAY_SORT_COLUMN array_sort_column[ARRAY_SORT_KEYS_MAX];
+    P_U32 p_index = NULL;
+    P_SS_DATA p_ss_data_sorted = NULL;
+    U32 i;
 
     assert((ss_data_get_data_id(p_ss_data) == RPN_RES_ARRAY) || (ss_data_get_data_id(p_ss_data) == RPN_TMP_ARRAY));
+    assert((n_keys > 0) && (n_keys <= ARRAY_SORT_KEYS_MAX));
 
-    {
-    U32 row_size = (U32) p_ss_data->arg.ss_array.x_size * sizeof32(SS_DATA);
+    if(n_keys > ARRAY_SORT_KEYS_MAX)
+        return(create_error(EVAL_ERR_FUNARGS));
 
-    if(x_index < (U32) p_ss_data->arg.ss_array.x_size)
+    for(i = 0; i < n_keys; ++i)
+        if(p_array_sort_key[i].x_index >= x_size)
+            return(create_error(EVAL_ERR_OUTOFRANGE));
+
+    if(y_size < 2)
+        return(STATUS_OK);
+
+    for(i = 0; i < n_keys; ++i)
     {
-        x_index_static = x_index;
-        qsort(p_ss_data->arg.ss_array.elements, (size_t) p_ss_data->arg.ss_array.y_size, row_size, proc_array_sort);
+        array_sort_column[i].p_ss_data_key = p_ss_data->arg.ss_array.elements + p_array_sort_key[i].x_index;
+        array_sort_column[i].stride = x_size;
+        array_sort_column[i].p_f64 = NULL;
+        array_sort_column[i].descending = p_array_sort_key[i].descending;
     }
-    else
-        status = create_error(EVAL_ERR_OUTOFRANGE);
-    } /*block*/
+
+    for(i = 0; i < n_keys; ++i)
+        if(status_fail(status = array_sort_column_reals(&array_sort_column[i], y_size)))
+            goto endpoint;
+
+    if(NULL == (p_index = al_ptr_alloc_elem(U32, 2 * y_size, &status)))
+        goto endpoint;
+
+    for(i = 0; i < y_size; ++i)
+        p_index[i] = i;
+
+    array_sort_merge(p_index, p_index + y_size, y_size, array_sort_column, n_keys);
+
+    /* gather the rows into their sorted order - elements move wholesale, their resources go with them */
+    if(NULL == (p_ss_data_sorted = al_ptr_alloc_elem(SS_DATA, x_size * y_size, &status)))
+        goto endpoint;
+
+    for(i = 0; i < y_size; ++i)
+        memcpy32(p_ss_data_sorted + (i * x_size), p_ss_data->arg.ss_array.elements + (p_index[i] * x_size), x_size * sizeof32(SS_DATA));
+
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&p_ss_data->arg.ss_array.elements));
+    p_ss_data->arg.ss_array.elements = p_ss_data_sorted;
+
+endpoint:
+
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&p_index));
+
+    for(i = 0; i < n_keys; ++i)
+        al_ptr_dispose(P_P_ANY_PEDANTIC(&array_sort_column[i].p_f64));
 
     return(status);
 }
 
+/******************************************************************************
+*
+* sort the rows of an array into ascending order of one column
+*
+******************************************************************************/
+
+_Check_return_
+extern STATUS
+array_sort(
+    P_SS_DATA p_ss_data,
+    _InVal_     U32 x_index)
+{
+    ARRAY_SORT_KEY array_sort_key;
+
+    array_sort_key.x_index = x_index;
+    array_sort_key.descending = FALSE;
+
+    return(array_sort_keys(p_ss_data, &array_sort_key, 1));
+}
+
+/******************************************************************************
+*
+* move the SLR made from a range in a conditional
+* RPN string to the cell being processed
+*
+******************************************************************************/
+
+static void
+cond_rpn_slr_adjust(
+    _InoutRef_  P_EV_SLR p_ev_slr,
+    _InRef_     PC_EV_SLR target_slrp,
+    BOOL abs_col,
+    BOOL abs_row)
+{
+    if(abs_col)
+        p_ev_slr->col  = ev_slr_col(target_slrp);
+    else
+        p_ev_slr->col += ev_slr_col(target_slrp);
+
+    if(abs_row)
+        p_ev_slr->row  = ev_slr_row(target_slrp);
+    else
+        p_ev_slr->row += ev_slr_row(target_slrp);
+}
+
 /******************************************************************************
 *
 * replace an rpn atom with an SLR when
@@ -870,17 +1102,23 @@ cond_rpn_range_adjust(
     S32 bytes_adjust,
     _InRef_     PC_EV_SLR target_slrp,
     BOOL abs_col,
-    BOOL abs_row)
+    BOOL abs_row,
+    P_DBASE_COND p_dbase_cond)
 {
-    if(abs_col)
-        p_ev_range->s.col  = ev_slr_col(target_slrp);
-    else
-        p_ev_range->s.col += ev_slr_col(target_slrp);
+    /* note where the SLR goes so it can be retargeted without all this */
+    if(p_dbase_cond)
+    {
+        if(p_dbase_cond->n_refs < DBASE_COND_MAX_REFS)
+        {
+            p_dbase_cond->ref_pos[p_dbase_cond->n_refs]  = (*out_pos + 1) - p_dbase_cond->rpn;
+            p_dbase_cond->ref_base[p_dbase_cond->n_refs] = p_ev_range->s;
+            p_dbase_cond->n_refs += 1;
+        }
+        else
+            p_dbase_cond->recompile = TRUE;
+    }
 
-    if(abs_row)
-        p_ev_range->s.row  = ev_slr_row(target_slrp);
-    else
-        p_ev_range->s.row += ev_slr_row(target_slrp);
+    cond_rpn_slr_adjust(&p_ev_range->s, target_slrp, abs_col, abs_row);
 
     *(*out_pos)++ = DATA_ID_SLR;
     *out_pos += write_slr(&p_ev_range->s, *out_pos);
@@ -1364,6 +1602,71 @@ ev_exp_free_resources(
     ev_result_free_resources(&p_ev_cell->ev_result);
 }
 
+/******************************************************************************
+*
+* convert conditional rpn for the current offset
+* without noting where its ranges went
+*
+******************************************************************************/
+
+extern S32
+ev_proc_conditional_rpn(
+    P_U8 rpn_out,
+    P_U8 rpn_in,
+    _InRef_     PC_EV_SLR target_slrp,
+    BOOL abs_col,
+    BOOL abs_row)
+{
+    return(proc_conditional_rpn(rpn_out, rpn_in, target_slrp, abs_col, abs_row, NULL));
+}
+
+/******************************************************************************
+*
+* compile a database condition for the first cell of
+* the database range, noting where its ranges went
+*
+******************************************************************************/
+
+extern void
+dbase_cond_compile(
+    _OutRef_    P_DBASE_COND p_dbase_cond,
+    P_U8 rpn_in,
+    _InRef_     PC_EV_SLR target_slrp,
+    BOOL abs_col,
+    BOOL abs_row)
+{
+    p_dbase_cond->n_refs = 0;
+    p_dbase_cond->recompile = FALSE;
+
+    (void) proc_conditional_rpn(p_dbase_cond->rpn, rpn_in, target_slrp, abs_col, abs_row, p_dbase_cond);
+}
+
+/******************************************************************************
+*
+* move a compiled database condition on to another cell
+* of the database range by rewriting just its SLRs
+*
+******************************************************************************/
+
+extern void
+dbase_cond_retarget(
+    _InoutRef_  P_DBASE_COND p_dbase_cond,
+    _InRef_     PC_EV_SLR target_slrp,
+    BOOL abs_col,
+    BOOL abs_row)
+{
+    S32 i;
+
+    for(i = 0; i < p_dbase_cond->n_refs; ++i)
+    {
+        EV_SLR slr = p_dbase_cond->ref_base[i];
+
+        cond_rpn_slr_adjust(&slr, target_slrp, abs_col, abs_row);
+
+        (void) write_slr(&slr, p_dbase_cond->rpn + p_dbase_cond->ref_pos[i]);
+    }
+}
+
 /******************************************************************************
 *
 * take conditional rpn string and convert to
@@ -1372,15 +1675,18 @@ ev_exp_free_resources(
 * col in target_slrp is an offset
 * row in target_slrp is absolute
 *
+* if p_dbase_cond is given, note where each range went
+*
 ******************************************************************************/
 
-extern S32
-ev_proc_conditional_rpn(
+static S32
+proc_conditional_rpn(
     P_U8 rpn_out,
     P_U8 rpn_in,
     _InRef_     PC_EV_SLR target_slrp,
     BOOL abs_col,
-    BOOL abs_row)
+    BOOL abs_row,
+    P_DBASE_COND p_dbase_cond)
 {
     RPNSTATE rpnb;
     P_U8 out_pos, skip_seen;
@@ -1406,7 +1712,7 @@ ev_proc_conditional_rpn(
             rpn_skip(&rpnb);
 
             cond_rpn_range_adjust(&rng, &skip_seen, &out_pos, (S32) PACKED_SLRSIZE - (S32) PACKED_RNGSIZE,
-                                  target_slrp, abs_col, abs_row);
+                                  target_slrp, abs_col, abs_row, p_dbase_cond);
 
             break;
             }
@@ -1417,6 +1723,10 @@ ev_proc_conditional_rpn(
             S32 name_processed = 0;
             EV_NAMEID nameid, name_num;
 
+            /* a name may be redefined as we go */
+            if(p_dbase_cond)
+                p_dbase_cond->recompile = TRUE;
+
             read_nameid(&nameid, rpnb.pos + 1);
 
             name_num = name_def_find(nameid);
@@ -1433,7 +1743,7 @@ ev_proc_conditional_rpn(
                     rpn_skip(&rpnb);
 
                     cond_rpn_range_adjust(&rng, &skip_seen, &out_pos, PACKED_SLRSIZE - sizeof(EV_NAMEID),
-                                          target_slrp, abs_col, abs_row);
+                                          target_slrp, abs_col, abs_row, p_dbase_cond);
 
                     name_processed = 1;
                 }
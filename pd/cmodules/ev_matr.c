@@ -138,6 +138,53 @@ determinant_3(
     return(STATUS_OK);
 }
 
+/* swap the tails of two rows, from the given column on */
+
+static void
+matrix_swap_rows(
+    _Inout_updates_(m*m) P_F64 ap /*[m][m]*/,
+    _InVal_     U32 m,
+    _InVal_     U32 row_idx_1,
+    _InVal_     U32 row_idx_2,
+    _InVal_     U32 start_col_idx)
+{
+    U32 col_idx;
+
+    for(col_idx = start_col_idx; col_idx < m; ++col_idx)
+    {
+        const F64 temp = _Aij(ap, m, row_idx_1, col_idx);
+        _Aij(ap, m, row_idx_1, col_idx) = _Aij(ap, m, row_idx_2, col_idx);
+        _Aij(ap, m, row_idx_2, col_idx) = temp;
+    }
+}
+
+/* find the row at or below the current one with the largest element in the current column */
+
+_Check_return_
+static U32
+matrix_pivot_row(
+    _In_reads_x_(m*m) PC_F64 ap /*[m][m]*/,
+    _InVal_     U32 m,
+    _InVal_     U32 curr_row_idx)
+{
+    U32 pivot_row_idx = curr_row_idx;
+    F64 pivot_abs = fabs(_Aij(ap, m, curr_row_idx, curr_row_idx));
+    U32 row_idx;
+
+    for(row_idx = curr_row_idx + 1; row_idx < m; ++row_idx)
+    {
+        const F64 test_abs = fabs(_Aij(ap, m, row_idx, curr_row_idx));
+
+        if(isgreater(test_abs, pivot_abs))
+        {
+            pivot_row_idx = row_idx;
+            pivot_abs = test_abs;
+        }
+    }
+
+    return(pivot_row_idx);
+}
+
 #define DETERMINANT_GAUSS_ELIMINATION 1
 
 #if !defined(DETERMINANT_GAUSS_ELIMINATION)
@@ -227,31 +274,30 @@ determinant_gauss_elimination(
     /* for each row (i==curr_row_idx) */
     for(curr_row_idx = 0; curr_row_idx < m; ++curr_row_idx)
     {
-        /* scale the whole row such that the element on the diagonal (Aii) is one */
-        const F64 initial_Aii = _Aij(ap, m, curr_row_idx, curr_row_idx);
-        F64 reciprocal_Aii;
+        /* partial pivoting: bring up the row with the largest element in the ith column */
+        const U32 pivot_row_idx = matrix_pivot_row(ap, m, curr_row_idx);
+        F64 Aii, reciprocal_Aii;
 
-        /* we are going to be dividing by Aii, so check validity */
-        if(!isgreater(fabs(initial_Aii), F64_MIN))
+        if(pivot_row_idx != curr_row_idx)
         {
-            *dp = 0.0; /* this is kosher */
-            break;
+            matrix_swap_rows(ap, m, curr_row_idx, pivot_row_idx, curr_row_idx);
+            *dp = -*dp; /* determinant changes sign with each row swap */
         }
 
-        *dp *= initial_Aii; /* determinant is scaled by this */
-
-        reciprocal_Aii = 1.0 / initial_Aii;
+        Aii = _Aij(ap, m, curr_row_idx, curr_row_idx);
 
-        /* for each column in the current row, scale together */
-        _Aij(ap, m, curr_row_idx, curr_row_idx) = 1.0; /* Aii := one */
-
-        /* note that values to the left of the (i)th column in the current row (and those below) are already zero, so we can skip scaling */
-        for(col_idx = curr_row_idx + 1; col_idx < m; ++col_idx)
+        /* we are going to be dividing by Aii, so check validity */
+        if(!isgreater(fabs(Aii), F64_MIN))
         {
-            _Aij(ap, m, curr_row_idx, col_idx) *= reciprocal_Aii;
+            *dp = 0.0; /* this is kosher - no usable pivot in this column */
+            break;
         }
 
-        /* for all succeding rows, subtract a multiple of this scaled current row to make the ith column zero */
+        *dp *= Aii; /* determinant is the product of the pivots */
+
+        reciprocal_Aii = 1.0 / Aii;
+
+        /* for all succeding rows, subtract a multiple of the current row to make the ith column zero */
         for(row_idx = curr_row_idx + 1; row_idx < m; ++row_idx)
         {
             F64 multiples;
@@ -259,9 +305,7 @@ determinant_gauss_elimination(
             if(0.0 == _Aij(ap, m, row_idx, curr_row_idx))
                 continue;
 
-            multiples = _Aij(ap, m, row_idx, curr_row_idx); /* as _Aij(ap, m, curr_row_idx, curr_row_idx) is now one */
-
-            _Aij(ap, m, row_idx, curr_row_idx) = 0.0; /* := zero */
+            multiples = _Aij(ap, m, row_idx, curr_row_idx) * reciprocal_Aii;
 
             /* note that values to the left of the (i)th column in the current row are zero */
             for(col_idx = curr_row_idx + 1; col_idx < m; ++col_idx)
@@ -271,7 +315,7 @@ determinant_gauss_elimination(
         }
     }
 
-    /* should end up with row-echelon form array - lower triangle zero, all diagonal elements one */
+    /* should end up with upper triangular array, whose diagonal we have multiplied up */
     al_ptr_dispose(P_P_ANY_PEDANTIC(&ap));
 
     return(status);
@@ -312,6 +356,140 @@ determinant(
     }
 }
 
+/******************************************************************************
+*
+* unpack a numeric array or range into a contiguous matrix
+*
+******************************************************************************/
+
+_Check_return_
+static STATUS
+matrix_load(
+    _Out_writes_(n_rows*n_cols) P_F64 ap /*[n_rows][n_cols]*/,
+    _InRef_     PC_SS_DATA p_ss_data,
+    _InVal_     U32 n_rows,
+    _InVal_     U32 n_cols)
+{
+    U32 i, j;
+
+    switch(ss_data_get_data_id(p_ss_data))
+    {
+    case RPN_TMP_ARRAY:
+    case RPN_RES_ARRAY:
+        /* all-number arrays unpack in one pass over the elements */
+        if( ((U32) p_ss_data->arg.ss_array.y_size == n_rows) &&
+            ((U32) p_ss_data->arg.ss_array.x_size == n_cols) &&
+            ss_array_reals_read(ap, p_ss_data) )
+            return(STATUS_OK);
+
+        break;
+
+    default:
+        break;
+    }
+
+    for(i = 0; i < n_rows; ++i)
+    {
+        for(j = 0; j < n_cols; ++j)
+        {
+            SS_DATA ss_data;
+
+            if(DATA_ID_REAL != array_range_index(&ss_data, p_ss_data, j, i, EM_REA)) /* NB j,i */
+                return(EVAL_ERR_MATRIX_NOT_NUMERIC);
+
+            f64_copy(_Aij(ap, n_cols, i, j), ss_data.arg.fp);
+        }
+    }
+
+    return(STATUS_OK);
+}
+
+/******************************************************************************
+*
+* invert an m-square matrix by Gauss-Jordan elimination with partial pivoting
+*
+* O(m^3) rather than the O(m^5) of forming the adjunct from m^2 minors
+*
+* trashes the input array
+*
+******************************************************************************/
+
+_Check_return_
+static STATUS
+inverse_gauss_jordan(
+    _Inout_updates_(m*m) P_F64 ap /*[m][m]*/,
+    _InVal_     U32 m,
+    _Out_writes_(m*m) P_F64 inv /*[m][m]*/)
+{
+    U32 curr_row_idx, row_idx, col_idx;
+    F64 D = 1.0;
+
+    /* start with the identity, which gets the same row operations as A */
+    for(row_idx = 0; row_idx < m; ++row_idx)
+        for(col_idx = 0; col_idx < m; ++col_idx)
+            _Aij(inv, m, row_idx, col_idx) = (row_idx == col_idx) ? 1.0 : 0.0;
+
+    for(curr_row_idx = 0; curr_row_idx < m; ++curr_row_idx)
+    {
+        const U32 pivot_row_idx = matrix_pivot_row(ap, m, curr_row_idx);
+        F64 Aii, reciprocal_Aii;
+
+        if(pivot_row_idx != curr_row_idx)
+        {
+            matrix_swap_rows(ap,  m, curr_row_idx, pivot_row_idx, curr_row_idx);
+            matrix_swap_rows(inv, m, curr_row_idx, pivot_row_idx, 0);
+            D = -D;
+        }
+
+        Aii = _Aij(ap, m, curr_row_idx, curr_row_idx);
+
+        /* we are going to be dividing by Aii, so check validity */
+        if(!isgreater(fabs(Aii), F64_MIN))
+            return(EVAL_ERR_MATRIX_SINGULAR);
+
+        D *= Aii;
+
+        /* scale the current row such that Aii is one */
+        reciprocal_Aii = 1.0 / Aii;
+
+        for(col_idx = curr_row_idx + 1; col_idx < m; ++col_idx)
+            _Aij(ap, m, curr_row_idx, col_idx) *= reciprocal_Aii;
+
+        for(col_idx = 0; col_idx < m; ++col_idx)
+            _Aij(inv, m, curr_row_idx, col_idx) *= reciprocal_Aii;
+
+        _Aij(ap, m, curr_row_idx, curr_row_idx) = 1.0;
+
+        /* for all other rows, subtract a multiple of the current row to make the ith column zero */
+        for(row_idx = 0; row_idx < m; ++row_idx)
+        {
+            F64 multiples;
+
+            if(row_idx == curr_row_idx)
+                continue;
+
+            multiples = _Aij(ap, m, row_idx, curr_row_idx);
+
+            if(0.0 == multiples)
+                continue;
+
+            _Aij(ap, m, row_idx, curr_row_idx) = 0.0;
+
+            for(col_idx = curr_row_idx + 1; col_idx < m; ++col_idx)
+                _Aij(ap, m, row_idx, col_idx) -= (multiples * _Aij(ap, m, curr_row_idx, col_idx));
+
+            for(col_idx = 0; col_idx < m; ++col_idx)
+                _Aij(inv, m, row_idx, col_idx) -= (multiples * _Aij(inv, m, curr_row_idx, col_idx));
+        }
+    }
+
+    /* same test as for the adjunct method */
+    if(!isgreater(fabs(D), F64_MIN))
+        return(EVAL_ERR_MATRIX_SINGULAR);
+
+    return(STATUS_OK);
+}
+
 #if RISCOS
 //#define POSSIBLE_VFP_SUPPORT 1
 #endif
@@ -352,25 +530,11 @@ PROC_EXEC_PROTO(c_m_determ)
 
     if(NULL != a)
     {
-        S32 i, j;
-
         assert(&_Aij(a, m, m - 1, m - 1) + 1 == &a[m * m]);
 
         /* load up the matrix (a) */
-        for(i = 0; i < m; ++i)
-        {
-            for(j = 0; j < m; ++j)
-            {
-                SS_DATA ss_data;
-
-                if(DATA_ID_REAL != array_range_index(&ss_data, args[0], j, i, EM_REA)) /* NB j,i */
-                    status_break(status = EVAL_ERR_MATRIX_NOT_NUMERIC);
-
-                f64_copy(_Aij(a, m, i, j), ss_data.arg.fp);
-            }
-        }
-
-        if(status_ok(status = determinant(a, m, &m_determ_result)))
+        if(status_ok(status = matrix_load(a, args[0], m, m)) &&
+           status_ok(status = determinant(a, m, &m_determ_result)))
         {
             ss_data_set_real(p_ss_data_res, m_determ_result);
         }
@@ -424,22 +588,21 @@ PROC_EXEC_PROTO(c_m_inverse)
         goto endpoint;
 
     /* load up the matrix (a) */
-    for(i = 0; i < m; ++i)
+    if(status_fail(status = matrix_load(a, args[0], m, m)))
+        goto endpoint;
+
+    if(m > 3)
     {
-        for(j = 0; j < m; ++j)
-        {
-            SS_DATA ss_data;
+        /* adj gets the inverse directly */
+        if(status_fail(status = inverse_gauss_jordan(a, m, adj)))
+            goto endpoint;
 
-            if(DATA_ID_REAL != array_range_index(&ss_data, args[0], j, i, EM_REA)) /* NB j,i */
-            {
-                status = EVAL_ERR_MATRIX_NOT_NUMERIC;
-                goto endpoint;
-            }
+        ss_array_reals_write(p_ss_data_res, adj);
 
-            f64_copy(_Aij(a, m, i, j), ss_data.arg.fp);
-        }
+        goto endpoint;
     }
 
+    /* small ones go via the adjunct */
     if(status_fail(status = determinant(a, m, &D)))
         goto endpoint;
 
@@ -542,10 +705,67 @@ endpoint:
 *
 ******************************************************************************/
 
+/* block size chosen so that three blocks of F64 sit comfortably in a small data cache */
+
+#define MATRIX_BLOCK 32
+
+/* C[n_rows][n_cols] += A[n_rows][n_inner] * B[n_inner][n_cols]
+ * each element of C is summed in ascending order of the inner index,
+ * just as the simple triple loop would do
+ */
+
+static void
+matrix_multiply_blocked(
+    _Inout_updates_(n_rows*n_cols) P_F64 cp,
+    _In_reads_(n_rows*n_inner) PC_F64 ap,
+    _In_reads_(n_inner*n_cols) PC_F64 bp,
+    _InVal_     U32 n_rows,
+    _InVal_     U32 n_inner,
+    _InVal_     U32 n_cols)
+{
+    U32 kk, ii, jj;
+
+    for(kk = 0; kk < n_inner; kk += MATRIX_BLOCK)
+    {
+        const U32 k_end = MIN(kk + MATRIX_BLOCK, n_inner);
+
+        for(ii = 0; ii < n_rows; ii += MATRIX_BLOCK)
+        {
+            const U32 i_end = MIN(ii + MATRIX_BLOCK, n_rows);
+
+            for(jj = 0; jj < n_cols; jj += MATRIX_BLOCK)
+            {
+                const U32 j_end = MIN(jj + MATRIX_BLOCK, n_cols);
+                U32 i, k, j;
+
+                for(i = ii; i < i_end; ++i)
+                {
+                    const P_F64 c_row = &_Aij(cp, n_cols, i, 0);
+
+                    for(k = kk; k < k_end; ++k)
+                    {
+                        const F64 a_ik = _Aij(ap, n_inner, i, k);
+                        const PC_F64 b_row = &_Aij(bp, n_cols, k, 0);
+
+                        /* unit stride over both rows */
+                        for(j = jj; j < j_end; ++j)
+                            c_row[j] += a_ik * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
 PROC_EXEC_PROTO(c_m_mult)
 {
+    STATUS status = STATUS_OK;
     S32 x_size[2];
     S32 y_size[2];
+    U32 n_rows, n_inner, n_cols;
+    P_F64 a /*[n_rows][n_inner]*/ = NULL;
+    P_F64 b /*[n_inner][n_cols]*/ = NULL;
+    P_F64 c /*[n_rows][n_cols]*/ = NULL;
 
     exec_func_ignore_parms();
 
@@ -556,40 +776,59 @@ PROC_EXEC_PROTO(c_m_mult)
     if(x_size[0] != y_size[1]) /* whinge about dimensions */
         exec_func_status_return(p_ss_data_res, EVAL_ERR_MISMATCHED_MATRICES);
 
-    if(status_ok(ss_array_make(p_ss_data_res, x_size[1], y_size[0])))
+    if(status_fail(ss_array_make(p_ss_data_res, x_size[1], y_size[0])))
+        return;
+
+    n_rows  = (U32) y_size[0];
+    n_inner = (U32) x_size[0];
+    n_cols  = (U32) x_size[1];
+
+    /* nothing to look at - and no elements to complain about */
+    if((0 == n_rows) || (0 == n_cols))
+        return;
+
+    /* unpack each operand once, rather than once per product */
+    if(0 != n_inner)
     {
-        S32 ix, iy;
+        if(NULL == (a = al_ptr_alloc_elem(F64, n_rows * n_inner, &status)))
+            goto endpoint;
 
-        for(ix = 0; ix < x_size[1]; ++ix)
-        {
-            for(iy = 0; iy < y_size[0]; ++iy)
-            {
-                F64 product = 0.0;
-                S32 elem;
-                P_SS_DATA elep;
+        if(NULL == (b = al_ptr_alloc_elem(F64, n_inner * n_cols, &status)))
+            goto endpoint;
 
-                for(elem = 0; elem < x_size[0]; elem++)
-                {
-                    SS_DATA ss_data[2];
+        if(status_fail(status = matrix_load(a, args[0], n_rows, n_inner)))
+            goto endpoint;
 
-                    (void) array_range_index(&ss_data[0], args[0], elem, iy, EM_REA);
-                    (void) array_range_index(&ss_data[1], args[1], ix, elem, EM_REA);
+        if(status_fail(status = matrix_load(b, args[1], n_inner, n_cols)))
+            goto endpoint;
+    }
 
-                    if( ss_data_is_real(&ss_data[0]) && ss_data_is_real(&ss_data[1]) )
-                    {
-                        product += ss_data_get_real(&ss_data[0]) * ss_data_get_real(&ss_data[1]);
-                    }
-                    else
-                    {
-                        ss_data_free_resources(p_ss_data_res);
-                        exec_func_status_return(p_ss_data_res, EVAL_ERR_MATRIX_NOT_NUMERIC);
-                    }
-                }
+    if(NULL == (c = al_ptr_alloc_elem(F64, n_rows * n_cols, &status)))
+        goto endpoint;
 
-                elep = ss_array_element_index_wr(p_ss_data_res, ix, iy);
-                ss_data_set_real(elep, product);
-            }
-        }
+    {
+    U32 i;
+
+    for(i = 0; i < n_rows * n_cols; ++i)
+        c[i] = 0.0;
+
+    if(0 != n_inner)
+        matrix_multiply_blocked(c, a, b, n_rows, n_inner, n_cols);
+
+    /* c[n_rows][n_cols] is laid out just as the result array's elements */
+    ss_array_reals_write(p_ss_data_res, c);
+    } /*block*/
+
+endpoint:
+
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&c));
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&b));
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&a));
+
+    if(status_fail(status))
+    {
+        ss_data_free_resources(p_ss_data_res);
+        ss_data_set_error(p_ss_data_res, status);
     }
 }
 
@@ -640,6 +879,28 @@ PROC_EXEC_PROTO(c_transpose)
     /* make a y-dimension by x-dimension result array and swap elements */
     if(status_ok(ss_array_make(p_ss_data_res, y_size, x_size)))
     {
+        switch(ss_data_get_data_id(args[0]))
+        {
+        case RPN_TMP_ARRAY:
+        case RPN_RES_ARRAY:
+            { /* arrays hold only constants, so copy them across directly without indexing and normalising each one */
+            PC_SS_DATA p_ss_data_in = args[0]->arg.ss_array.elements;
+
+            for(iy = 0; iy < y_size; ++iy)
+            {
+                P_SS_DATA p_ss_data_out = p_ss_data_res->arg.ss_array.elements + iy;
+
+                for(ix = 0; ix < x_size; ++ix, ++p_ss_data_in, p_ss_data_out += y_size)
+                    status_assert(ss_data_resource_copy(p_ss_data_out, p_ss_data_in));
+            }
+
+            return;
+            }
+
+        default:
+            break;
+        }
+
         for(ix = 0; ix < x_size; ++ix)
         {
             for(iy = 0; iy < y_size; ++iy)
@@ -576,6 +576,11 @@ rpn_skip(
                 /* skip skip argument */
                 rpnsp->pos += 1 + sizeof(S16);
                 break;
+            case RPN_FRM_FOLD:
+                /* skip length and folded constant to step into the original rpn */
+                rpnsp->pos += sizeof(S16);
+                rpnsp->num = (EV_IDNO) *rpnsp->pos;
+                return(rpn_skip(rpnsp));
             case RPN_FRM_NODEP:
             default:
                 break;
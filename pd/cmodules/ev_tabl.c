@@ -219,6 +219,7 @@ const RPNDEF rpn_table[] =
     { RPN_FRM, NAI, EV_RESO_NOTME   ,         NAP, NAS,              NAA }, /* skip rpn if false */
     { RPN_FRM, NAI, EV_RESO_NOTME   ,         NAP, NAS,              NAA }, /* skip rpn if true */
     { RPN_FRM, NAI, EV_RESO_NOTME   ,         NAP, NAS,              NAA }, /* no dependency */
+    { RPN_FRM, NAI, EV_RESO_NOTME   ,         NAP, NAS,              NAA }, /* folded constant */
 
     { RPN_UOP,   1, EV_RESO_NOTME   ,         NAP, c_uop_not,        arg_BOO },
     { RPN_UOP,   1, EV_RESO_NOTME   ,         NAP, c_uop_minus,      arg_IoR }, /* unary - */
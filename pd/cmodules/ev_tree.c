@@ -23,6 +23,8 @@
 internal functions
 */
 
+PROC_QSORT_PROTO(static, rngcomp, RANGE_USE);
+
 PROC_QSORT_PROTO(static, slrcomp, SLR_USE);
 
 PROC_QSORT_PROTO(static, todocomp, TODO_ENTRY);
@@ -37,6 +39,15 @@ todo_add_slr(
     _InRef_     PC_EV_SLR slrp,
     S32 sort);
 
+static void
+todo_add_rng_dependents(
+    _InoutRef_  P_SS_DOC p_ss_doc,
+    _InRef_     PC_EV_SLR slrp);
+
+static void
+tree_rng_itree_build(
+    _InoutRef_  P_SS_DOC p_ss_doc);
+
 static void
 tree_sort_custom_use(void);
 
@@ -95,6 +106,20 @@ block size increments
 #define RNGBLKINC  20
 #define TDOBLKINC 250
 
+/*
+maximum number of entries that we will shuffle up
+to keep a table sorted when adding a dependency;
+beyond this it's cheaper to append and merge later
+*/
+
+#define DEP_INSERT_MAX_MOVE 1024
+
+/*
+range tables smaller than this are just scanned
+*/
+
+#define RNG_ITREE_MIN 64
+
 /******************************************************************************
 *
 * add a use to the list of custom uses
@@ -248,6 +273,54 @@ dep_table_check_free_some(
     }
 }
 
+/******************************************************************************
+*
+* find where to add an entry to a sorted dependency table
+* so that the table remains sorted
+*
+* --out--
+* <  0 table can't be kept sorted; append entry and blow trees
+* >= 0 index at which to insert entry
+*
+******************************************************************************/
+
+static EV_TRENT
+dep_table_insert_point(
+    P_DEPTABLE dpp,
+    S32 ent_size,
+    PC_ANY p_key,
+    sort_proctp sort_proc)
+{
+    PC_U8 p_base = (PC_U8) dpp->ptr;
+    EV_TRENT lo, hi;
+
+    /* can't move entries about under the recalc's feet */
+    if(tree_flags & TRF_LOCK)
+        return(-1);
+
+    if((dpp->sorted != dpp->next) || (NULL == p_base))
+        return(-1);
+
+    /* find first entry that sorts after the key */
+    lo = 0;
+    hi = dpp->next;
+
+    while(lo < hi)
+    {
+        EV_TRENT mid = lo + ((hi - lo) >> 1);
+
+        if((* sort_proc) (p_key, p_base + (mid * ent_size)) < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    if(dpp->next - lo > DEP_INSERT_MAX_MOVE)
+        return(-1);
+
+    return(lo);
+}
+
 /******************************************************************************
 *
 * add an entry to the external dependency list
@@ -403,7 +476,23 @@ ev_add_rngdependency(
 
     target.refto = grubp->data.arg.range;
 
-    rix = p_ss_doc->range_table.next;
+    if((rix = dep_table_insert_point(&p_ss_doc->range_table,
+                                     sizeof32(RANGE_USE),
+                                     &target,
+                                     rngcomp)) < 0)
+    {
+        rix = p_ss_doc->range_table.next;
+        tree_flags |= TRF_BLOWN;
+    }
+    else
+    {
+        ++p_ss_doc->range_table.sorted;
+
+        /* entries are shuffled up so the index is no longer valid */
+        if(rix < p_ss_doc->range_table.next)
+            tree_rng_itree_dispose(p_ss_doc);
+    }
+
     rep = tree_rngptr(p_ss_doc, rix);
     __assume(rep);
     /* create a space to insert */
@@ -419,8 +508,6 @@ ev_add_rngdependency(
     rep->flags    = 0;
     rep->visited  = 0;
 
-    tree_flags |= TRF_BLOWN;
-
     return(0);
 }
 
@@ -437,6 +524,7 @@ ev_add_slrdependency(
     P_SS_DOC p_ss_doc;
     P_SLR_USE sep;
     EV_TRENT six;
+    SLR_USE target;
 
     if((p_ss_doc = ev_p_ss_doc_from_docno(grubp->data.arg.slr.docno)) == NULL)
         return(-1);
@@ -446,7 +534,19 @@ ev_add_slrdependency(
                                SLRBLKINC) < 0)
         return(-1);
 
-    six = p_ss_doc->slr_table.next;
+    target.refto = grubp->data.arg.slr;
+
+    if((six = dep_table_insert_point(&p_ss_doc->slr_table,
+                                     sizeof32(SLR_USE),
+                                     &target,
+                                     slrcomp)) < 0)
+    {
+        six = p_ss_doc->slr_table.next;
+        tree_flags |= TRF_BLOWN;
+    }
+    else
+        ++p_ss_doc->slr_table.sorted;
+
     sep = tree_slrptr(p_ss_doc, six);
     __assume(sep);
     /* create a space to insert */
@@ -461,8 +561,6 @@ ev_add_slrdependency(
     sep->byoffset = grubp->byoffset;
     sep->flags    = 0;
 
-    tree_flags |= TRF_BLOWN;
-
     return(0);
 }
 
@@ -1158,26 +1256,16 @@ todo_add_dependents(
 {
     P_SS_DOC p_ss_doc;
 
+    /* the cell's value has changed */
+    range_cache_inform(slrp);
+
     if(NULL != (p_ss_doc = ev_p_ss_doc_from_docno(ev_slr_docno(slrp))))
     {
-        P_RANGE_USE rep;
         P_SLR_USE sep;
         EV_TRENT six;
 
         /* look thru range dependencies */
-        if((rep = tree_rngptr(p_ss_doc, 0)) != NULL)
-        {
-            EV_TRENT rix;
-
-            for(rix = 0; rix < p_ss_doc->range_table.next; ++rix, ++rep)
-            {
-                if(rep->flags & TRF_TOBEDEL)
-                    continue;
-
-                if(ev_slr_in_range(&rep->refto, slrp))
-                    todo_add_slr(&rep->byslr, TODO_SORT);
-            }
-        }
+        todo_add_rng_dependents(p_ss_doc, slrp);
 
         /* find slr dependents */
         six = search_for_slrdependent(slrp);
@@ -1201,6 +1289,104 @@ todo_add_dependents(
     todo_add_name_deps_of_slr(slrp, FALSE);
 }
 
+/******************************************************************************
+*
+* add the dependents of ranges containing a cell to the todo list
+*
+* uses the range table's interval index, if it has one, for the
+* entries it covers and scans the rest
+*
+******************************************************************************/
+
+static void
+todo_add_rng_dependents(
+    _InoutRef_  P_SS_DOC p_ss_doc,
+    _InRef_     PC_EV_SLR slrp)
+{
+    P_RANGE_USE rep;
+    EV_TRENT rix = 0;
+
+    tree_sort_range_use(ev_slr_docno(slrp));
+
+    if((rep = tree_rngptr(p_ss_doc, 0)) == NULL)
+        return;
+
+    if(p_ss_doc->rng_itree_n > p_ss_doc->range_table.sorted)
+        tree_rng_itree_dispose(p_ss_doc);
+
+    if(NULL == p_ss_doc->rng_itree)
+        tree_rng_itree_build(p_ss_doc);
+
+    if(NULL != p_ss_doc->rng_itree)
+    {
+        const EV_COL col = ev_slr_col(slrp);
+        const EV_TRENT n_indexed = p_ss_doc->rng_itree_n;
+        EV_TRENT node_stack[64];
+        S32 level_stack[64];
+        S32 sp = 0;
+
+        node_stack[sp] = ((EV_TRENT) 1 << p_ss_doc->rng_itree_level) - 1;
+        level_stack[sp] = p_ss_doc->rng_itree_level;
+        ++sp;
+
+        while(sp > 0)
+        {
+            EV_TRENT node, half;
+            S32 level;
+
+            --sp;
+            node = node_stack[sp];
+            level = level_stack[sp];
+
+            /* nothing in this subtree extends as far as this column */
+            if(p_ss_doc->rng_itree[node] <= col)
+                continue;
+
+            if(level > 0)
+            {
+                half = (EV_TRENT) 1 << (level - 1);
+
+                /* left subtree ranges all start at or before this one */
+                node_stack[sp] = node - half;
+                level_stack[sp] = level - 1;
+                ++sp;
+            }
+            else
+                half = 0;
+
+            /* padding node - its right subtree is all padding too */
+            if(node >= n_indexed)
+                continue;
+
+            /* this range and all in the right subtree start beyond the column */
+            if(rep[node].refto.s.col > col)
+                continue;
+
+            if(!(rep[node].flags & TRF_TOBEDEL) && ev_slr_in_range(&rep[node].refto, slrp))
+                todo_add_slr(&rep[node].byslr, TODO_SORT);
+
+            if(level > 0)
+            {
+                node_stack[sp] = node + half;
+                level_stack[sp] = level - 1;
+                ++sp;
+            }
+        }
+
+        rix = n_indexed;
+    }
+
+    /* scan entries not covered by the index */
+    for(rep += rix; rix < p_ss_doc->range_table.next; ++rix, ++rep)
+    {
+        if(rep->flags & TRF_TOBEDEL)
+            continue;
+
+        if(ev_slr_in_range(&rep->refto, slrp))
+            todo_add_slr(&rep->byslr, TODO_SORT);
+    }
+}
+
 /******************************************************************************
 *
 * mark all dependents (users of a custom function) for recalc
@@ -1601,6 +1787,61 @@ tree_remove_tobedel(
     return(blown);
 }
 
+/******************************************************************************
+*
+* sort the unsorted tail of a dependency table and merge it
+* into the sorted part, rather than sorting the whole table
+*
+* --out--
+* FALSE tail too large (or no memory) - caller must sort whole table
+*
+******************************************************************************/
+
+static BOOL
+tree_merge_tail(
+    P_DEPTABLE dpp,
+    S32 ent_size,
+    sort_proctp sort_proc)
+{
+    const EV_TRENT n_tail = dpp->next - dpp->sorted;
+    P_U8 p_base = (P_U8) dpp->ptr;
+    P_U8 p_tail_copy;
+    EV_TRENT i_out, i_sorted, i_tail;
+    STATUS status;
+
+    /* not worth it if most of the table needs sorting */
+    if(n_tail > dpp->sorted)
+        return(FALSE);
+
+    if(NULL == (p_tail_copy = al_ptr_alloc_bytes(P_U8, n_tail * ent_size, &status)))
+        return(FALSE);
+
+    qsort(p_base + (dpp->sorted * ent_size), n_tail, ent_size, sort_proc);
+    memcpy32(p_tail_copy, p_base + (dpp->sorted * ent_size), n_tail * ent_size);
+
+    /* merge from the top down so that we never overwrite unmerged entries */
+    i_out    = dpp->next;
+    i_sorted = dpp->sorted;
+    i_tail   = n_tail;
+
+    while(i_tail > 0)
+    {
+        PC_U8 p_in;
+
+        if( (i_sorted > 0) &&
+            ((* sort_proc) (p_base + ((i_sorted - 1) * ent_size), p_tail_copy + ((i_tail - 1) * ent_size)) > 0) )
+            p_in = p_base + (--i_sorted * ent_size);
+        else
+            p_in = p_tail_copy + (--i_tail * ent_size);
+
+        memcpy32(p_base + (--i_out * ent_size), p_in, ent_size);
+    }
+
+    al_ptr_free(p_tail_copy);
+
+    return(TRUE);
+}
+
 /******************************************************************************
 *
 * generic routine to sort trees
@@ -1624,7 +1865,8 @@ tree_sort(
         if(dpp->ptr)
         {
             trace_0(TRACE_MODULE_EVAL, "** sort **");
-            qsort((P_U8) dpp->ptr, dpp->next, ent_size, sort_proc);
+            if(!tree_merge_tail(dpp, ent_size, sort_proc))
+                qsort((P_U8) dpp->ptr, dpp->next, ent_size, sort_proc);
 
             dpp->sorted = dpp->next;
             blown = 1;
@@ -1634,6 +1876,84 @@ tree_sort(
     return(blown);
 }
 
+/******************************************************************************
+*
+* build an interval index over the sorted part of a range table
+*
+* the index is an implicit binary tree laid over the table entries, which
+* are sorted by start column; leaves are the even entries, and a node at
+* level k has children at +/- 2^(k-1); each node holds the maximum end
+* column of the ranges in its subtree so that finding the ranges
+* containing a column need only descend into subtrees which reach it
+*
+******************************************************************************/
+
+static void
+tree_rng_itree_build(
+    _InoutRef_  P_SS_DOC p_ss_doc)
+{
+    const EV_TRENT n_entries = p_ss_doc->range_table.sorted;
+    P_RANGE_USE rep = tree_rngptr(p_ss_doc, 0);
+    P_EV_COL p_max_col;
+    EV_TRENT i, n_nodes;
+    S32 level, root_level;
+    STATUS status;
+
+    tree_rng_itree_dispose(p_ss_doc);
+
+    if((NULL == rep) || (n_entries < RNG_ITREE_MIN))
+        return;
+
+    /* index can only be laid over entries in start column order */
+    for(i = 1; i < n_entries; ++i)
+        if( (rep[i].refto.s.docno != rep[0].refto.s.docno) ||
+            (rep[i].refto.s.col < rep[i - 1].refto.s.col) )
+            return;
+
+    /* pad out to a complete tree */
+    root_level = 0;
+    while((((EV_TRENT) 2 << root_level) - 1) < n_entries)
+        ++root_level;
+
+    n_nodes = ((EV_TRENT) 2 << root_level) - 1;
+
+    if(NULL == (p_max_col = al_ptr_alloc_elem(EV_COL, n_nodes, &status)))
+        return;
+
+    for(i = 0; i < n_nodes; ++i)
+        p_max_col[i] = ((i < n_entries) && !(rep[i].flags & TRF_TOBEDEL)) ? rep[i].refto.e.col : 0;
+
+    for(level = 1; level <= root_level; ++level)
+    {
+        const EV_TRENT half = (EV_TRENT) 1 << (level - 1);
+
+        for(i = ((EV_TRENT) 1 << level) - 1; i < n_nodes; i += ((EV_TRENT) 2 << level))
+        {
+            p_max_col[i] = MAX(p_max_col[i], p_max_col[i - half]);
+            p_max_col[i] = MAX(p_max_col[i], p_max_col[i + half]);
+        }
+    }
+
+    p_ss_doc->rng_itree = p_max_col;
+    p_ss_doc->rng_itree_n = n_entries;
+    p_ss_doc->rng_itree_level = root_level;
+}
+
+/******************************************************************************
+*
+* discard a range table's interval index
+*
+******************************************************************************/
+
+extern void
+tree_rng_itree_dispose(
+    _InoutRef_  P_SS_DOC p_ss_doc)
+{
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&p_ss_doc->rng_itree));
+    p_ss_doc->rng_itree_n = 0;
+    p_ss_doc->rng_itree_level = 0;
+}
+
 /******************************************************************************
 *
 * sort all the trees
@@ -1738,7 +2058,10 @@ tree_sort_range_use(
                  RNGBLKINC,
                  offsetof32(RANGE_USE, flags),
                  rngcomp))
+    {
+        tree_rng_itree_dispose(p_ss_doc);
         tree_flags |= TRF_BLOWN;
+    }
 }
 
 /******************************************************************************
@@ -25,6 +25,27 @@
 internal functions
 */
 
+#define UREF_BATCH_MAX 16
+
+static UREF_PARM uref_batch[UREF_BATCH_MAX];
+
+static S32 uref_batch_n = 0;
+
+static S32 uref_batch_level = 0;
+
+static void
+uref_batch_flush(void);
+
+_Check_return_
+static BOOL
+uref_batchable(
+    _InRef_     PC_UREF_PARM upp);
+
+static void
+uref_steps(
+    _InRef_     PC_UREF_PARM upps,
+    _InVal_     S32 n_upps);
+
 static S32
 match_slr_e(
     _InoutRef_  P_EV_SLR ref,
@@ -42,6 +63,11 @@ uref_cdoc(
     _InoutRef_  P_EV_SLR ref,
     _InRef_     PC_EV_SLR to);
 
+static S32
+uref_permute(
+    _InoutRef_  P_EV_SLR ref,
+    _InRef_     PC_UREF_PARM upp);
+
 static S32
 uref_swap(
     _InoutRef_  P_EV_SLR ref,
@@ -261,6 +287,39 @@ ev_match_rng(
 
         break;
 
+    case UREF_PERMUTE:
+        if(!(p_ev_range->s.flags & SLR_ALL_REF))
+        {
+            S32 colspan, rowspan;
+
+            rng_set_span(p_ev_range, upp, &colspan, &rowspan);
+
+            /* a single row range moves with its row; others are left where they are */
+            if(colspan && rowspan && (p_ev_range->e.row == p_ev_range->s.row + 1))
+            {
+                if(uref_permute(&p_ev_range->s, upp) == DEP_UPDATE)
+                {
+                    p_ev_range->e.row = p_ev_range->s.row + 1;
+                    res = DEP_UPDATE;
+                }
+            }
+            else
+            {
+                /* tell people who have ranges affected at all */
+                EV_RANGE rng;
+
+                rng.s = upp->slr1;
+                rng.e = upp->slr2;
+
+                if(ev_range_overlap(p_ev_range, &rng))
+                    res = DEP_INFORM;
+            }
+        }
+        else
+            res = DEP_INFORM;
+
+        break;
+
     case UREF_CHANGEDOC:
         if(p_ev_range->s.docno == upp->slr2.docno)
         {
@@ -389,6 +448,15 @@ ev_match_slr(
             res = uref_swap(ref, &upp->slr1, &upp->slr2);
         break;
 
+    case UREF_PERMUTE:
+        if(ref->row >= upp->slr1.row &&
+           ref->col >= upp->slr1.col &&
+           ref->row <  upp->slr2.row &&
+           ref->col <  upp->slr2.col &&
+           (ref->docno == upp->slr2.docno))
+            res = uref_permute(ref, upp);
+        break;
+
     case UREF_CHANGEDOC:
         if(ref->docno == upp->slr2.docno)
             res = uref_cdoc(ref, &upp->slr1);
@@ -478,108 +546,267 @@ ev_match_slr(
 *   slr1.docno is being told about rename
 *   slr2.docno is being renamed
 *
+* UREF_PERMUTE
+*   slr1, slr2 are tl, br of block whose rows have been reordered
+*   p_permute[row - slr1.row] is the new row of each old row
+*
 ******************************************************************************/
 
 extern void
 ev_uref(
     _InRef_     PC_UREF_PARM upp)
 {
-    trace_0(TRACE_MODULE_UREF, "ev_uref in -- ");
+    if(uref_batch_level && uref_batchable(upp))
+    {
+        if(uref_batch_n >= UREF_BATCH_MAX)
+            uref_batch_flush();
 
-#if TRACE_ALLOWED
+        uref_batch[uref_batch_n++] = *upp;
+        return;
+    }
+
+    /* anything held back must go first */
+    uref_batch_flush();
+
+    uref_steps(upp, 1);
+}
+
+/******************************************************************************
+*
+* hold back urefs for cell moves and deletions in the same document until
+* ev_uref_batch_end(), then apply them all in one pass over the trees
+*
+* NOTE:
+* nothing that looks in the trees may be called while urefs are held back
+*
+******************************************************************************/
+
+extern void
+ev_uref_batch_start(void)
+{
+    ++uref_batch_level;
+}
+
+extern void
+ev_uref_batch_end(void)
+{
+    assert(uref_batch_level > 0);
+
+    if(0 == --uref_batch_level)
+        uref_batch_flush();
+}
+
+/******************************************************************************
+*
+* can a uref be held back in a batch?
+*
+******************************************************************************/
+
+_Check_return_
+static BOOL
+uref_batchable(
+    _InRef_     PC_UREF_PARM upp)
+{
     switch(upp->action)
     {
-    case UREF_CHANGE:
-        trace_0(TRACE_MODULE_UREF, "UREF_CHANGE ");
-        break;
     case UREF_UREF:
-        trace_0(TRACE_MODULE_UREF, "UREF_UREF ");
-        break;
+        /* references mustn't move between document trees */
+        return(upp->slr3.docno == upp->slr2.docno);
+
     case UREF_DELETE:
-        trace_0(TRACE_MODULE_UREF, "UREF_DELETE ");
-        break;
-    case UREF_SWAP:
-        trace_0(TRACE_MODULE_UREF, "UREF_SWAP ");
-        break;
-    case UREF_CHANGEDOC:
-        trace_0(TRACE_MODULE_UREF, "UREF_CHANGEDOC ");
-        break;
     case UREF_REPLACE:
-        trace_0(TRACE_MODULE_UREF, "UREF_REPLACE ");
-        break;
-    case UREF_SWAPCELL:
-        trace_0(TRACE_MODULE_UREF, "UREF_SWAPCELL ");
-        break;
-    case UREF_CLOSE:
-        trace_0(TRACE_MODULE_UREF, "UREF_CLOSE ");
-        break;
-    case UREF_REDRAW:
-        trace_0(TRACE_MODULE_UREF, "UREF_REDRAW ");
-        break;
-    case UREF_RENAME:
-        trace_0(TRACE_MODULE_UREF, "UREF_RENAME ");
-        break;
+        return(TRUE);
+
     default:
-        assert(0);
-        break;
+        return(FALSE);
     }
-#endif
+}
 
-    /* blow up the evaluator when things move under its feet */
-    switch(upp->action)
+/******************************************************************************
+*
+* apply any held back urefs
+*
+******************************************************************************/
+
+static void
+uref_batch_flush(void)
+{
+    UREF_PARM upps[UREF_BATCH_MAX];
+    S32 n_upps = uref_batch_n;
+
+    if(0 == n_upps)
+        return;
+
+    trace_1(TRACE_MODULE_UREF, "uref_batch_flush applying %d urefs", n_upps);
+
+    /* take them off the queue first, in case a dependent urefs again */
+    memcpy32(upps, uref_batch, sizeof32(upps[0]) * n_upps);
+    uref_batch_n = 0;
+
+    uref_steps(upps, n_upps);
+}
+
+/******************************************************************************
+*
+* which parts of the evaluator does a uref action affect?
+*
+******************************************************************************/
+
+#define UREF_DOES_STACK 1   /* evaluator stack */
+#define UREF_DOES_TODO  2   /* todo list */
+#define UREF_DOES_EXT   4   /* external dependencies */
+#define UREF_DOES_TREES 8   /* range, slr, name and custom trees */
+
+_Check_return_
+static S32
+uref_does(
+    _InVal_     S32 action)
+{
+    switch(action)
     {
     case UREF_CHANGE:
     case UREF_REDRAW:
-        break;
+        return(UREF_DOES_EXT);
+
+    case UREF_RENAME:
+        return(UREF_DOES_STACK | UREF_DOES_EXT);
 
     case UREF_REPLACE:
+        return(UREF_DOES_STACK | UREF_DOES_EXT | UREF_DOES_TREES);
+
     case UREF_UREF:
     case UREF_DELETE:
     case UREF_SWAP:
+    case UREF_PERMUTE:
     case UREF_CHANGEDOC:
     case UREF_SWAPCELL:
     case UREF_CLOSE:
-    case UREF_RENAME:
-        stack_zap(upp);
-        break;
+        return(UREF_DOES_STACK | UREF_DOES_TODO | UREF_DOES_EXT | UREF_DOES_TREES);
+
+    default:
+        assert(0);
+        return(0);
     }
+}
 
-    /* look through the todo list */
-    switch(upp->action)
+/******************************************************************************
+*
+* apply a sequence of urefs, making one pass over each table
+*
+* each entry is taken through the urefs in turn, so the result is as
+* if they had been applied one by one; references compiled into cells
+* are rewritten once, where the cells are after the last uref
+*
+******************************************************************************/
+
+static void
+uref_steps(
+    _InRef_     PC_UREF_PARM upps,
+    _InVal_     S32 n_upps)
+{
+    S32 does = 0;
+    S32 k;
+
+    trace_0(TRACE_MODULE_UREF, "ev_uref in -- ");
+
+    for(k = 0; k < n_upps; ++k)
     {
-    P_TODO_ENTRY todop;
+        PC_UREF_PARM upp = &upps[k];
 
-    case UREF_REDRAW:
-    case UREF_CHANGE:
-    case UREF_REPLACE:
-    case UREF_RENAME:
-        break;
+#if TRACE_ALLOWED
+        switch(upp->action)
+        {
+        case UREF_CHANGE:
+            trace_0(TRACE_MODULE_UREF, "UREF_CHANGE ");
+            break;
+        case UREF_UREF:
+            trace_0(TRACE_MODULE_UREF, "UREF_UREF ");
+            break;
+        case UREF_DELETE:
+            trace_0(TRACE_MODULE_UREF, "UREF_DELETE ");
+            break;
+        case UREF_SWAP:
+            trace_0(TRACE_MODULE_UREF, "UREF_SWAP ");
+            break;
+        case UREF_CHANGEDOC:
+            trace_0(TRACE_MODULE_UREF, "UREF_CHANGEDOC ");
+            break;
+        case UREF_REPLACE:
+            trace_0(TRACE_MODULE_UREF, "UREF_REPLACE ");
+            break;
+        case UREF_SWAPCELL:
+            trace_0(TRACE_MODULE_UREF, "UREF_SWAPCELL ");
+            break;
+        case UREF_CLOSE:
+            trace_0(TRACE_MODULE_UREF, "UREF_CLOSE ");
+            break;
+        case UREF_REDRAW:
+            trace_0(TRACE_MODULE_UREF, "UREF_REDRAW ");
+            break;
+        case UREF_RENAME:
+            trace_0(TRACE_MODULE_UREF, "UREF_RENAME ");
+            break;
+        case UREF_PERMUTE:
+            trace_0(TRACE_MODULE_UREF, "UREF_PERMUTE ");
+            break;
+        default:
+            assert(0);
+            break;
+        }
+#endif
+
+        does |= uref_does(upp->action);
+
+        /* forget what is cached about ranges with anything changed or moved */
+        switch(upp->action)
+        {
+        case UREF_REDRAW:
+            break;
+
+        case UREF_CHANGE:
+            range_cache_inform(&upp->slr1);
+            break;
+
+        default:
+            range_cache_inform(NULL);
+            break;
+        }
+
+        /* blow up the evaluator when things move under its feet */
+        if(uref_does(upp->action) & UREF_DOES_STACK)
+            stack_zap(upp);
+    }
+
+    /* look through the todo list */
+    if(does & UREF_DOES_TODO)
+    {
+        P_TODO_ENTRY todop;
 
-    case UREF_UREF:
-    case UREF_DELETE:
-    case UREF_SWAP:
-    case UREF_CHANGEDOC:
-    case UREF_SWAPCELL:
-    case UREF_CLOSE:
         if((todop = todo_ptr(0)) != NULL)
         {
             EV_TRENT tix;
 
             for(tix = 0; tix < todotab.next; ++tix, ++todop)
             {
-                S32 res;
+                for(k = 0; k < n_upps; ++k)
+                {
+                    S32 res;
 
-                if(todop->flags & TRF_TOBEDEL)
-                    continue;
+                    if(todop->flags & TRF_TOBEDEL)
+                        break;
 
-                if((res = ev_match_slr(&todop->slr, upp)) == DEP_DELETE)
-                {
-                    todop->flags  |= TRF_TOBEDEL;
-                    todotab.flags |= TRF_TOBEDEL;
-                    todotab.mindel = MIN(todotab.mindel, tix);
+                    if(!(uref_does(upps[k].action) & UREF_DOES_TODO))
+                        continue;
+
+                    if((res = ev_match_slr(&todop->slr, &upps[k])) == DEP_DELETE)
+                    {
+                        todop->flags  |= TRF_TOBEDEL;
+                        todotab.flags |= TRF_TOBEDEL;
+                        todotab.mindel = MIN(todotab.mindel, tix);
+                    }
+                    else if(res != DEP_INFORM)
+                        todotab.sorted = 0;
                 }
-                else if(res != DEP_INFORM)
-                    todotab.sorted = 0;
             }
         }
     }
@@ -602,253 +829,269 @@ ev_uref(
             p_ss_doc = ev_p_ss_doc_from_docno_must(docno);
 
             /* look through external dependencies */
-            switch(upp->action)
+            if(does & UREF_DOES_EXT)
             {
-            case UREF_UREF:
-            case UREF_DELETE:
-            case UREF_SWAP:
-            case UREF_CHANGEDOC:
-            case UREF_CHANGE:
-            case UREF_REDRAW:
-            case UREF_REPLACE:
-            case UREF_SWAPCELL:
-            case UREF_CLOSE:
-            case UREF_RENAME:
                 if((eep = tree_extptr(p_ss_doc, 0)) != NULL)
                 {
                     EV_TRENT i;
 
                     for(i = 0; i < p_ss_doc->exttab.next; ++i, ++eep)
                     {
-                        S32 res;
+                        for(k = 0; k < n_upps; ++k)
+                        {
+                            PC_UREF_PARM upp = &upps[k];
+                            S32 res;
 
-                        if(eep->flags & TRF_TOBEDEL)
-                            continue;
+                            if(eep->flags & TRF_TOBEDEL)
+                                break;
 
-                        if((res = ev_match_rng(&eep->refto, upp)) != DEP_NONE)
-                        {
-                            (eep->proc)(&eep->refto,
-                                        upp,
-                                        eep->exthandle,
-                                        eep->inthandle,
-                                        res);
-
-                            /* refs to deleted area must be removed */
-                            if(res == DEP_DELETE && upp->action != UREF_REPLACE)
+                            if((res = ev_match_rng(&eep->refto, upp)) != DEP_NONE)
                             {
-                                eep->flags |= TRF_TOBEDEL;
-                                p_ss_doc->exttab.flags |= TRF_TOBEDEL;
-                                p_ss_doc->exttab.mindel = MIN(p_ss_doc->exttab.mindel, i);
-                                continue;
+                                (eep->proc)(&eep->refto,
+                                            upp,
+                                            eep->exthandle,
+                                            eep->inthandle,
+                                            res);
+
+                                /* refs to deleted area must be removed */
+                                if(res == DEP_DELETE && upp->action != UREF_REPLACE)
+                                {
+                                    eep->flags |= TRF_TOBEDEL;
+                                    p_ss_doc->exttab.flags |= TRF_TOBEDEL;
+                                    p_ss_doc->exttab.mindel = MIN(p_ss_doc->exttab.mindel, i);
+                                }
+                                else
+                                    doc_move_extref(p_ss_doc, docno, eep, i);
                             }
-                            else
-                                doc_move_extref(p_ss_doc, docno, eep, i);
                         }
                     }
                 }
-                break;
             }
 
+            if(!(does & UREF_DOES_TREES))
+                continue;
+
             /* look through the range tree */
-            switch(upp->action)
+            if((rep = tree_rngptr(p_ss_doc, 0)) != NULL)
             {
-            case UREF_CHANGE:
-            case UREF_REDRAW:
-            case UREF_RENAME:
-                break;
+                EV_TRENT i;
 
-            case UREF_UREF:
-            case UREF_DELETE:
-            case UREF_SWAP:
-            case UREF_CHANGEDOC:
-            case UREF_REPLACE:
-            case UREF_SWAPCELL:
-            case UREF_CLOSE:
-                if((rep = tree_rngptr(p_ss_doc, 0)) != NULL)
+                for(i = 0; i < p_ss_doc->range_table.next; ++i, ++rep)
                 {
-                    EV_TRENT i;
+                    BOOL matched = FALSE, updated = FALSE;
+
+                    if(rep->flags & TRF_TOBEDEL)
+                        continue;
 
-                    for(i = 0; i < p_ss_doc->range_table.next; ++i, ++rep)
+                    /* refs contained by deleted area must be removed */
+                    for(k = 0; k < n_upps; ++k)
+                        if((uref_does(upps[k].action) & UREF_DOES_TREES) &&
+                           (ev_match_slr(&rep->byslr, &upps[k]) == DEP_DELETE))
+                            break;
+
+                    if(k < n_upps)
+                    {
+                        rep->flags |= TRF_TOBEDEL;
+                        p_ss_doc->range_table.flags |= TRF_TOBEDEL;
+                        p_ss_doc->range_table.mindel = MIN(p_ss_doc->range_table.mindel, i);
+                        continue;
+                    }
+
+                    for(k = 0; k < n_upps; ++k)
                     {
                         S32 res;
 
-                        if(rep->flags & TRF_TOBEDEL)
+                        if(!(uref_does(upps[k].action) & UREF_DOES_TREES))
                             continue;
 
-                        /* refs contained by deleted area must be removed */
-                        if(ev_match_slr(&rep->byslr, upp) == DEP_DELETE)
+                        if((res = ev_match_rng(&rep->refto, &upps[k])) != DEP_NONE)
                         {
-                            rep->flags |= TRF_TOBEDEL;
-                            p_ss_doc->range_table.flags |= TRF_TOBEDEL;
-                            p_ss_doc->range_table.mindel = MIN(p_ss_doc->range_table.mindel, i);
-                            continue;
+                            matched = TRUE;
+
+                            if(res != DEP_INFORM)
+                                updated = TRUE;
                         }
+                    }
 
-                        /* if reference to matched, find the reference
-                        in the compiled string and update that */
-                        if((res = ev_match_rng(&rep->refto, upp)) != DEP_NONE)
-                        {
-                            P_EV_CELL p_ev_cell;
-                            S32 travel_res;
+                    /* if reference to matched, find the reference
+                    in the compiled string and update that */
+                    if(matched)
+                    {
+                        P_EV_CELL p_ev_cell;
+                        S32 travel_res;
 
-                            /* mark for recalc */
-                            ev_todo_add_slr(&rep->byslr, TODO_SORT);
+                        /* mark for recalc */
+                        ev_todo_add_slr(&rep->byslr, TODO_SORT);
 
-                            if(res != DEP_INFORM)
+                        if(updated)
+                        {
+                            if(rep->byoffset >= 0 &&
+                               (travel_res = ev_travel(&p_ev_cell, &rep->byslr)) != 0)
                             {
-                                if(rep->byoffset >= 0 &&
-                                   (travel_res = ev_travel(&p_ev_cell, &rep->byslr)) != 0)
+                                /* internal format cells */
+                                if(travel_res > 0)
+                                {
+                                    EV_RANGE temp_rng;
+
+                                    read_range(  &temp_rng,
+                                                 p_ev_cell->rpn.var.rpn_str +
+                                                 rep->byoffset);
+                                    for(k = 0; k < n_upps; ++k)
+                                        if(uref_does(upps[k].action) & UREF_DOES_TREES)
+                                            ev_match_rng(&temp_rng, &upps[k]);
+                                    write_rng   (&temp_rng,
+                                                 p_ev_cell->rpn.var.rpn_str +
+                                                 rep->byoffset);
+                                }
+                                /* external format cells */
+                                else
                                 {
-                                    /* internal format cells */
-                                    if(travel_res > 0)
-                                    {
-                                        EV_RANGE temp_rng;
-
-                                        read_range(  &temp_rng,
-                                                     p_ev_cell->rpn.var.rpn_str +
-                                                     rep->byoffset);
-                                        ev_match_rng(&temp_rng, upp);
-                                        write_rng   (&temp_rng,
-                                                     p_ev_cell->rpn.var.rpn_str +
-                                                     rep->byoffset);
-                                    }
-                                    /* external format cells */
-                                    else
-                                        ev_ext_uref(&rep->byslr,
-                                                    rep->byoffset,
-                                                    upp);
+                                    for(k = 0; k < n_upps; ++k)
+                                        if(uref_does(upps[k].action) & UREF_DOES_TREES)
+                                            ev_ext_uref(&rep->byslr,
+                                                        rep->byoffset,
+                                                        &upps[k]);
                                 }
+                            }
 
-                                doc_move_rngref(p_ss_doc, docno, rep, i);
+                            doc_move_rngref(p_ss_doc, docno, rep, i);
 
-                                p_ss_doc->range_table.sorted = 0;
-                            }
+                            p_ss_doc->range_table.sorted = 0;
                         }
                     }
                 }
-                break;
             }
 
             /* look through slr tree */
-            switch(upp->action)
+            if((sep = tree_slrptr(p_ss_doc, 0)) != NULL)
             {
-            case UREF_CHANGE:
-            case UREF_REDRAW:
-            case UREF_RENAME:
-                break;
+                EV_TRENT i;
 
-            case UREF_UREF:
-            case UREF_DELETE:
-            case UREF_SWAP:
-            case UREF_CHANGEDOC:
-            case UREF_REPLACE:
-            case UREF_SWAPCELL:
-            case UREF_CLOSE:
-                if((sep = tree_slrptr(p_ss_doc, 0)) != NULL)
+                for(i = 0; i < p_ss_doc->slr_table.next; ++i, ++sep)
                 {
-                    EV_TRENT i;
+                    BOOL matched = FALSE, updated = FALSE;
 
-                    for(i = 0; i < p_ss_doc->slr_table.next; ++i, ++sep)
+                    if(sep->flags & TRF_TOBEDEL)
+                        continue;
+
+                    /* refs contained by deleted area
+                     * must be removed
+                    */
+                    for(k = 0; k < n_upps; ++k)
+                        if((uref_does(upps[k].action) & UREF_DOES_TREES) &&
+                           (ev_match_slr(&sep->byslr, &upps[k]) == DEP_DELETE))
+                            break;
+
+                    if(k < n_upps)
+                    {
+                        sep->flags |= TRF_TOBEDEL;
+                        p_ss_doc->slr_table.flags |= TRF_TOBEDEL;
+                        p_ss_doc->slr_table.mindel = MIN(p_ss_doc->slr_table.mindel, i);
+                        continue;
+                    }
+
+                    for(k = 0; k < n_upps; ++k)
                     {
                         S32 res;
 
-                        if(sep->flags & TRF_TOBEDEL)
+                        if(!(uref_does(upps[k].action) & UREF_DOES_TREES))
                             continue;
 
-                        /* refs contained by deleted area
-                         * must be removed
-                        */
-                        if(ev_match_slr(&sep->byslr, upp) == DEP_DELETE)
+                        if((res = ev_match_slr(&sep->refto, &upps[k])) != DEP_NONE)
                         {
-                            sep->flags |= TRF_TOBEDEL;
-                            p_ss_doc->slr_table.flags |= TRF_TOBEDEL;
-                            p_ss_doc->slr_table.mindel = MIN(p_ss_doc->slr_table.mindel, i);
-                            continue;
+                            matched = TRUE;
+
+                            if(res != DEP_INFORM)
+                                updated = TRUE;
                         }
+                    }
 
-                        /* if ref_to matched, find the reference
-                        in the compiled string and update that */
-                        if((res = ev_match_slr(&sep->refto, upp)) != DEP_NONE)
-                        {
-                            P_EV_CELL p_ev_cell;
-                            S32 travel_res;
+                    /* if ref_to matched, find the reference
+                    in the compiled string and update that */
+                    if(matched)
+                    {
+                        P_EV_CELL p_ev_cell;
+                        S32 travel_res;
 
-                            /* mark for recalc */
-                            ev_todo_add_slr(&sep->byslr, TODO_SORT);
+                        /* mark for recalc */
+                        ev_todo_add_slr(&sep->byslr, TODO_SORT);
 
-                            if(res != DEP_INFORM)
+                        if(updated)
+                        {
+                            if(sep->byoffset >= 0 &&
+                               (travel_res = ev_travel(&p_ev_cell, &sep->byslr)) != 0)
                             {
-                                if(sep->byoffset >= 0 &&
-                                   (travel_res = ev_travel(&p_ev_cell, &sep->byslr)) != 0)
+                                /* internal format cells */
+                                if(travel_res > 0)
                                 {
-                                    /* internal format cells */
-                                    if(travel_res > 0)
-                                    {
-                                        EV_SLR temp_slr;
-
-                                        read_slr    (&temp_slr,
-                                                     p_ev_cell->rpn.var.rpn_str +
-                                                     sep->byoffset);
-                                        ev_match_slr(&temp_slr, upp);
-                                        write_slr   (&temp_slr,
-                                                     p_ev_cell->rpn.var.rpn_str +
-                                                     sep->byoffset);
-                                    }
-                                    /* external format cells */
-                                    else
-                                        ev_ext_uref(&sep->byslr,
-                                                    sep->byoffset,
-                                                    upp);
+                                    EV_SLR temp_slr;
+
+                                    read_slr    (&temp_slr,
+                                                 p_ev_cell->rpn.var.rpn_str +
+                                                 sep->byoffset);
+                                    for(k = 0; k < n_upps; ++k)
+                                        if(uref_does(upps[k].action) & UREF_DOES_TREES)
+                                            ev_match_slr(&temp_slr, &upps[k]);
+                                    write_slr   (&temp_slr,
+                                                 p_ev_cell->rpn.var.rpn_str +
+                                                 sep->byoffset);
                                 }
+                                /* external format cells */
+                                else
+                                {
+                                    for(k = 0; k < n_upps; ++k)
+                                        if(uref_does(upps[k].action) & UREF_DOES_TREES)
+                                            ev_ext_uref(&sep->byslr,
+                                                        sep->byoffset,
+                                                        &upps[k]);
+                                }
+                            }
 
-                                doc_move_slrref(p_ss_doc, docno, sep, i);
+                            doc_move_slrref(p_ss_doc, docno, sep, i);
 
-                                p_ss_doc->slr_table.sorted = 0;
-                            }
+                            p_ss_doc->slr_table.sorted = 0;
                         }
                     }
                 }
-                break;
             }
         }
     }
 
-    if(upp->action == UREF_CHANGEDOC)
-        change_doc_mac_nam(upp->slr1.docno, upp->slr2.docno);
+    for(k = 0; k < n_upps; ++k)
+        if(upps[k].action == UREF_CHANGEDOC)
+            change_doc_mac_nam(upps[k].slr1.docno, upps[k].slr2.docno);
+
+    if(!(does & UREF_DOES_TREES))
+    {
+        trace_0(TRACE_MODULE_UREF, " -- out");
+        return;
+    }
 
     /* look through the name use table */
-    switch(upp->action)
     {
     P_NAME_USE nep;
 
-    case UREF_CHANGE:
-    case UREF_REDRAW:
-    case UREF_RENAME:
-        break;
-
-    case UREF_UREF:
-    case UREF_DELETE:
-    case UREF_SWAP:
-    case UREF_CHANGEDOC:
-    case UREF_REPLACE:
-    case UREF_SWAPCELL:
-    case UREF_CLOSE:
-        if((nep = tree_namptr(0)) != NULL)
-        {
-            EV_TRENT i;
-            S32 check_use = 0, un_sort = 0;
+    if((nep = tree_namptr(0)) != NULL)
+    {
+        EV_TRENT i;
+        S32 check_use = 0, un_sort = 0;
 
-            name_list_sort();
+        name_list_sort();
 
-            for(i = 0; i < name_use_deptable.next; ++i, ++nep)
+        for(i = 0; i < name_use_deptable.next; ++i, ++nep)
+        {
+            for(k = 0; k < n_upps; ++k)
             {
                 S32 res;
 
                 if(nep->flags & TRF_TOBEDEL)
+                    break;
+
+                if(!(uref_does(upps[k].action) & UREF_DOES_TREES))
                     continue;
 
                 /* refs contained by deleted area must be removed */
-                if((res = ev_match_slr(&nep->byslr, upp)) == DEP_DELETE)
+                if((res = ev_match_slr(&nep->byslr, &upps[k])) == DEP_DELETE)
                 {
                     nep->flags   |= TRF_TOBEDEL;
                     name_use_deptable.flags |= TRF_TOBEDEL;
@@ -858,42 +1101,36 @@ ev_uref(
                 else if(res == DEP_UPDATE)
                     un_sort = 1;
             }
-
-            /* set these flags at end to avoid sorts
-             * in the middle of our fuddle
-             */
-            if(check_use)
-                names_def_deptable.flags |= TRF_CHECKUSE;
-            if(un_sort)
-                name_use_deptable.sorted = 0;
         }
-        break;
+
+        /* set these flags at end to avoid sorts
+         * in the middle of our fuddle
+         */
+        if(check_use)
+            names_def_deptable.flags |= TRF_CHECKUSE;
+        if(un_sort)
+            name_use_deptable.sorted = 0;
     }
+    } /*block*/
 
     /* look through name definition table */
-    switch(upp->action)
     {
     P_EV_NAME p_ev_name;
 
-    case UREF_CHANGE:
-    case UREF_REDRAW:
-    case UREF_RENAME:
-        break;
+    if((p_ev_name = names_def_deptable.ptr) != NULL)
+    {
+        EV_NAMEID i;
 
-    case UREF_UREF:
-    case UREF_DELETE:
-    case UREF_SWAP:
-    case UREF_CHANGEDOC:
-    case UREF_REPLACE:
-    case UREF_SWAPCELL:
-    case UREF_CLOSE:
-        if((p_ev_name = names_def_deptable.ptr) != NULL)
+        for(i = 0; i < names_def_deptable.next; ++i, ++p_ev_name)
         {
-            EV_NAMEID i;
-
-            for(i = 0; i < names_def_deptable.next; ++i, ++p_ev_name)
+            for(k = 0; k < n_upps; ++k)
             {
+                PC_UREF_PARM upp = &upps[k];
+
                 if(p_ev_name->flags & TRF_TOBEDEL)
+                    break;
+
+                if(!(uref_does(upp->action) & UREF_DOES_TREES))
                     continue;
 
                 /* check for name definition in the area */
@@ -938,42 +1175,34 @@ ev_uref(
                 }
             }
         }
-        break;
     }
+    } /*block*/
 
     /* look through the custom use table */
-    switch(upp->action)
     {
     P_CUSTOM_USE mep;
 
-    case UREF_CHANGE:
-    case UREF_REDRAW:
-    case UREF_RENAME:
-        break;
-
-    case UREF_UREF:
-    case UREF_DELETE:
-    case UREF_SWAP:
-    case UREF_CHANGEDOC:
-    case UREF_REPLACE:
-    case UREF_SWAPCELL:
-    case UREF_CLOSE:
-        if((mep = tree_macptr(0)) != NULL)
-        {
-            EV_TRENT i;
-            S32 check_use = 0, un_sort = 0;
+    if((mep = tree_macptr(0)) != NULL)
+    {
+        EV_TRENT i;
+        S32 check_use = 0, un_sort = 0;
 
-            custom_list_sort();
+        custom_list_sort();
 
-            for(i = 0; i < custom_use_deptable.next; ++i, ++mep)
+        for(i = 0; i < custom_use_deptable.next; ++i, ++mep)
+        {
+            for(k = 0; k < n_upps; ++k)
             {
                 S32 res;
 
                 if(mep->flags & TRF_TOBEDEL)
+                    break;
+
+                if(!(uref_does(upps[k].action) & UREF_DOES_TREES))
                     continue;
 
                 /* custom uses contained by deleted area must be removed */
-                if((res = ev_match_slr(&mep->byslr, upp)) == DEP_DELETE)
+                if((res = ev_match_slr(&mep->byslr, &upps[k])) == DEP_DELETE)
                 {
                     mep->flags |= TRF_TOBEDEL;
                     custom_use_deptable.flags |= TRF_TOBEDEL;
@@ -983,46 +1212,38 @@ ev_uref(
                 else if(res == DEP_UPDATE)
                     un_sort = 1;
             }
-
-            /* set these flags at end to avoid sorts
-             * in the middle of our fuddle
-             */
-            if(check_use)
-                custom_def_deptable.flags |= TRF_CHECKUSE;
-            if(un_sort)
-                custom_use_deptable.sorted = 0;
         }
-        break;
+
+        /* set these flags at end to avoid sorts
+         * in the middle of our fuddle
+         */
+        if(check_use)
+            custom_def_deptable.flags |= TRF_CHECKUSE;
+        if(un_sort)
+            custom_use_deptable.sorted = 0;
     }
+    } /*block*/
 
     /* update custom definition table */
-    switch(upp->action)
     {
     P_EV_CUSTOM p_ev_custom;
 
-    case UREF_CHANGE:
-    case UREF_REDRAW:
-    case UREF_RENAME:
-        break;
+    if((p_ev_custom = custom_def_deptable.ptr) != NULL)
+    {
+        EV_NAMEID i;
 
-    case UREF_UREF:
-    case UREF_DELETE:
-    case UREF_SWAP:
-    case UREF_CHANGEDOC:
-    case UREF_REPLACE:
-    case UREF_SWAPCELL:
-    case UREF_CLOSE:
-        if((p_ev_custom = custom_def_deptable.ptr) != NULL)
+        for(i = 0; i < custom_def_deptable.next; ++i, ++p_ev_custom)
         {
-            EV_NAMEID i;
-
-            for(i = 0; i < custom_def_deptable.next; ++i, ++p_ev_custom)
+            for(k = 0; k < n_upps; ++k)
             {
                 if(p_ev_custom->flags & TRF_TOBEDEL)
+                    break;
+
+                if(!(uref_does(upps[k].action) & UREF_DOES_TREES))
                     continue;
 
                 /* check for custom definition in the area */
-                if(ev_match_slr(&p_ev_custom->owner, upp) == DEP_DELETE)
+                if(ev_match_slr(&p_ev_custom->owner, &upps[k]) == DEP_DELETE)
                 {
                     /* delete custom table entry
                      * if there are no dependents
@@ -1044,8 +1265,8 @@ ev_uref(
                 }
             }
         }
-        break;
     }
+    } /*block*/
 
     trace_0(TRACE_MODULE_UREF, " -- out");
 }
@@ -1137,6 +1358,26 @@ uref_swap(
     return(DEP_UPDATE);
 }
 
+/******************************************************************************
+*
+* update reference when rows are reordered
+*
+******************************************************************************/
+
+static S32
+uref_permute(
+    _InoutRef_  P_EV_SLR ref,
+    _InRef_     PC_UREF_PARM upp)
+{
+    const EV_ROW new_row = upp->p_permute[ref->row - upp->slr1.row];
+
+    if(new_row == ref->row)
+        return(DEP_NONE);
+
+    ref->row = new_row;
+    return(DEP_UPDATE);
+}
+
 /******************************************************************************
 *
 * update reference when cells are swapped
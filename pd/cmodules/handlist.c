@@ -90,6 +90,12 @@ fillbefore(
     LIST_ITEMNO itemfill,
     LIST_ITEMNO adjust);
 
+static S32
+findpool(
+    pooldp pooldblkp,
+    S32 pooldblkfree,
+    LIST_ITEMNO item);
+
 static pooldp
 getpooldp(
     P_LIST_BLOCK lp,
@@ -567,6 +573,10 @@ list_freepoolspace(
 * garbage collect for a list, removing
 * adjacent filler blocks
 *
+* done in one pass, leaping from each item to the next so that a filler
+* is visited once however many items it covers, and coalescing any run
+* of fillers into its first before moving on
+*
 ******************************************************************************/
 
 extern S32
@@ -576,42 +586,60 @@ list_garbagecollect(
     LIST_ITEMNO item, nextitem;
     P_LIST_ITEM it;
     LIST_ITEMNO fill;
-    S32 res;
+    S32 res = 0;
 
     validatepools();
 
-    for(item = 0, res = 0; item < list_numitem(lp); ++item)
+    item = 0;
+
+    while(item < list_numitem(lp))
     {
-        it = list_igotoitem(lp, item);
+        if((it = list_igotoitem(lp, item)) == NULL)
+            break;
 
-        if(it && (it->flags & LIST_FILL) && (item == list_atitem(lp)))
+        if(item != list_atitem(lp))
         {
-            nextitem = item + list_leapnext(it);
-            it = list_igotoitem(lp, nextitem);
-
-            if(it &&
-               (it->flags & LIST_FILL) &&
-               ((nextitem == list_atitem(lp)) ||
-                (nextitem == list_numitem(lp)))
-              )
-            {
-                fill = it->i.itemfill;
-                deallocitem(lp, it);
-                updatepoolitems(lp, -fill);
-                if( ((it = list_igotoitem(lp, item)) != NULL) &&
-                    (it->flags & LIST_FILL))
-                {
-                    it->i.itemfill += fill;
-                    updatepoolitems(lp, fill);
-                }
+            /* landed inside an entry that starts earlier - step past it */
+            item = MAX(item + 1, list_atitem(lp) + list_leapnext(it));
+            continue;
+        }
+
+        if(!(it->flags & LIST_FILL))
+        {
+            ++item;
+            continue;
+        }
 
-                res += 1;
+        nextitem = item + list_leapnext(it);
+        it = list_igotoitem(lp, nextitem);
 
-                #ifdef SPARSE_DEBUG
-                trace_0(TRACE_MODULE_LIST, "Filler recovered");
-                #endif
+        if(it &&
+           (it->flags & LIST_FILL) &&
+           ((nextitem == list_atitem(lp)) ||
+            (nextitem == list_numitem(lp)))
+          )
+        {
+            fill = it->i.itemfill;
+            deallocitem(lp, it);
+            updatepoolitems(lp, -fill);
+            if( ((it = list_igotoitem(lp, item)) != NULL) &&
+                (it->flags & LIST_FILL))
+            {
+                it->i.itemfill += fill;
+                updatepoolitems(lp, fill);
             }
+
+            res += 1;
+
+            #ifdef SPARSE_DEBUG
+            trace_0(TRACE_MODULE_LIST, "Filler recovered");
+            #endif
+
+            /* stay put: this filler may now abut another; each time round frees an entry, so this ends */
+            continue;
         }
+
+        item = nextitem;
     }
 
     validatepools();
@@ -690,16 +718,16 @@ list_gotoitem(
         return(!(it->flags & LIST_FILL) ? it : NULL);
     }
 
-    /* skip backwards to pool if necessary */
-    if(item < pdp->poolitem)
+    /* go straight to the pool holding the item, rather than stepping
+     * through every pool in between, if it's not in the current one
+    */
+    if( (item < pdp->poolitem) ||
+        ((lp->ix_pooldesc + 1 < lp->pooldblkfree) && (item >= (pdp + 1)->poolitem)) )
     {
-        do
-            {
-            --lp->ix_pooldesc;
-            --lp->poold;
-            --pdp;
-        }
-        while(item < pdp->poolitem);
+        const pooldp pooldblkp = pdp - lp->ix_pooldesc;
+
+        lp->ix_pooldesc = findpool(pooldblkp, lp->pooldblkfree, item);
+        lp->poold = pdp = pooldblkp + lp->ix_pooldesc;
 
         i = pdp->poolitem;
         pp = getpoolptr(pdp);
@@ -1706,6 +1734,35 @@ fillbefore(
     return(it);
 }
 
+/******************************************************************************
+*
+* binary search the pool descriptors for the
+* last pool whose first item is at or before item
+*
+******************************************************************************/
+
+static S32
+findpool(
+    pooldp pooldblkp,
+    S32 pooldblkfree,
+    LIST_ITEMNO item)
+{
+    S32 lo = 0;
+    S32 hi = pooldblkfree - 1;
+
+    while(lo < hi)
+    {
+        const S32 mid = lo + (hi - lo + 1) / 2;
+
+        if(pooldblkp[mid].poolitem <= item)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    return(lo);
+}
+
 /******************************************************************************
 *
 * get pointer to descriptor block
@@ -164,10 +164,192 @@ linest_solve_system(
     return(status);
 }
 
+/******************************************************************************
+*
+* Solve a larger system of m simultaneous linear equations
+*
+* Cramer's Rule evaluates m+1 determinants, each by expansion in minors,
+* so use Gaussian elimination with partial pivoting once m gets going
+*
+******************************************************************************/
+
+#define LINEST_CRAMER_MAX_M 3
+
+_Check_return_
+static STATUS
+linest_solve_system_gauss(
+    P_F64 A /*[m][m]*/ /*trashed*/,
+    P_F64 C /*[m]*/ /*trashed*/,
+    P_F64 X /*[m]*/ /*out*/,
+    _InVal_     U32 m)
+{
+    U32 curr_row_idx, row_idx, col_idx;
+
+    /* NB data_in_columns, so row i, column j is A[i + (j * m)] */
+    for(curr_row_idx = 0; curr_row_idx < m; ++curr_row_idx)
+    {
+        U32 pivot_row_idx = curr_row_idx;
+        F64 Aii;
+
+        for(row_idx = curr_row_idx + 1; row_idx < m; ++row_idx)
+            if(isgreater(fabs(A[row_idx + (curr_row_idx * m)]), fabs(A[pivot_row_idx + (curr_row_idx * m)])))
+                pivot_row_idx = row_idx;
+
+        if(pivot_row_idx != curr_row_idx)
+        {
+            F64 temp;
+
+            for(col_idx = curr_row_idx; col_idx < m; ++col_idx)
+            {
+                temp = A[curr_row_idx + (col_idx * m)];
+                A[curr_row_idx  + (col_idx * m)] = A[pivot_row_idx + (col_idx * m)];
+                A[pivot_row_idx + (col_idx * m)] = temp;
+            }
+
+            temp = C[curr_row_idx];
+            C[curr_row_idx]  = C[pivot_row_idx];
+            C[pivot_row_idx] = temp;
+        }
+
+        Aii = A[curr_row_idx + (curr_row_idx * m)];
+
+        if(Aii == 0.0)
+            return(EVAL_ERR_MATRIX_SINGULAR); /* insoluble */
+
+        for(row_idx = curr_row_idx + 1; row_idx < m; ++row_idx)
+        {
+            const F64 multiples = A[row_idx + (curr_row_idx * m)] / Aii;
+
+            if(0.0 == multiples)
+                continue;
+
+            for(col_idx = curr_row_idx + 1; col_idx < m; ++col_idx)
+                A[row_idx + (col_idx * m)] -= multiples * A[curr_row_idx + (col_idx * m)];
+
+            C[row_idx] -= multiples * C[curr_row_idx];
+        }
+    }
+
+    /* back substitute */
+    row_idx = m;
+
+    while(row_idx-- > 0)
+    {
+        F64 sum = C[row_idx];
+
+        for(col_idx = row_idx + 1; col_idx < m; ++col_idx)
+            sum -= A[row_idx + (col_idx * m)] * X[col_idx];
+
+        X[row_idx] = sum / A[row_idx + (row_idx * m)];
+    }
+
+    return(STATUS_OK);
+}
+
 /*
 Solve the system of simultaneous linear equations AX=C
 by the method of linear least squares: square up to the
 normal equations by multiplying both sides by transpose(A)
+
+The normal equations are accumulated one data point at a time
+*/
+
+_Check_return_
+extern STATUS
+linest_accumulator_init(
+    _OutRef_    P_LINEST_ACCUMULATOR p_linest_accumulator,
+    _InVal_     U32 ext_m /* number of independent x variables */)
+{
+    const U32 m = ext_m + 1;
+    STATUS status;
+    U32 i;
+
+    p_linest_accumulator->m = m;
+    p_linest_accumulator->n = 0;
+                                                                     /* M,  V,  x */
+    if(NULL == (p_linest_accumulator->M = al_ptr_alloc_bytes(P_F64, (m + 1 + 1) * m * sizeof32(F64), &status)))
+    {
+        p_linest_accumulator->V = NULL;
+        p_linest_accumulator->x = NULL;
+        return(status);
+    }
+
+    p_linest_accumulator->V = p_linest_accumulator->M + (m * m);
+    p_linest_accumulator->x = p_linest_accumulator->V + m;
+
+    for(i = 0; i < (m + 1) * m; ++i)
+        p_linest_accumulator->M[i] = 0.0;
+
+    return(STATUS_OK);
+}
+
+extern void
+linest_accumulator_add(
+    _InoutRef_  P_LINEST_ACCUMULATOR p_linest_accumulator,
+    _In_reads_(ext_m) PC_F64 x,
+    _InVal_     F64 y)
+{
+    const U32 m = p_linest_accumulator->m;
+    const P_F64 M = p_linest_accumulator->M;
+    const P_F64 V = p_linest_accumulator->V;
+    U32 i, j;
+
+    /* a_0r is 1.0 for the constant, a_ir is x[i-1] */
+
+    /* Vi += a_ir * c_r */
+    V[0] += y;
+
+    for(i = 1; i < m; ++i)
+        V[i] += x[i - 1] * y;
+
+    /* Mij += a_ir * a_jr for i <= j, the rest being symmetric */
+    M[0] += 1.0;
+
+    for(j = 1; j < m; ++j)
+    {
+        const F64 a_jr = x[j - 1];
+
+        M[0 + (j * m)] += a_jr;
+
+        for(i = 1; i <= j; ++i)
+            M[i + (j * m)] += x[i - 1] * a_jr;
+    }
+
+    p_linest_accumulator->n += 1;
+}
+
+_Check_return_
+extern STATUS
+linest_accumulator_solve(
+    _InoutRef_  P_LINEST_ACCUMULATOR p_linest_accumulator,
+    _Out_writes_(m) P_F64 X)
+{
+    const U32 m = p_linest_accumulator->m;
+    const P_F64 M = p_linest_accumulator->M;
+    U32 i, j;
+
+    /* fill in the lower triangle */
+    for(j = 0; j < m; ++j)
+        for(i = j + 1; i < m; ++i)
+            M[i + (j * m)] = M[j + (i * m)];
+
+    if(m <= LINEST_CRAMER_MAX_M)
+        return(linest_solve_system(M, p_linest_accumulator->V, X, m));
+
+    return(linest_solve_system_gauss(M, p_linest_accumulator->V, X, m));
+}
+
+extern void
+linest_accumulator_dispose(
+    _InoutRef_  P_LINEST_ACCUMULATOR p_linest_accumulator)
+{
+    al_ptr_dispose(P_P_ANY_PEDANTIC(&p_linest_accumulator->M)); /* and V, x too */
+    p_linest_accumulator->V = NULL;
+    p_linest_accumulator->x = NULL;
+}
+
+/*
+linest() over a data source: each data point is asked for just once, in row order
 */
 
 _Check_return_
@@ -179,71 +361,35 @@ linest(
     _InVal_     U32 ext_m   /* number of independent x variables */,
     _InVal_     U32 n       /* number of data points */)
 {
-    U32 m = ext_m + 1;
-    P_F64 M /*[m][m]*/; /* transpose(A).A */
-    P_F64 V /*[m]*/; /* transpose(A).C */
+    LINEST_ACCUMULATOR linest_accumulator;
     P_F64 X /*[m]*/; /* result vector */
-    U32 i, j, r;
-    F64 c_r;
-    F64 a_ir, a_jr;
+    U32 i, r;
     STATUS status;
-                                /* X,  V,  M */
-    if(NULL == (X = al_ptr_alloc_bytes(P_F64, (1 + 1 + m) * m * sizeof32(*X), &status)))
-        return(status);
 
-    V = X + m;
-    M = V + m;
+    status_return(linest_accumulator_init(&linest_accumulator, ext_m));
 
-    /* fill V vector (transpose(A).C) */
-    for(i = 0; i < m; ++i)
+    if(NULL == (X = al_ptr_alloc_elem(F64, linest_accumulator.m, &status)))
     {
-        /* Vi = sum_over_r(a_ir * c_r) */
-        P_F64 v_i = &V[i];
-
-        for(*v_i = 0.0, r = 0; r < n; ++r)
-        {
-            a_ir = (i == 0)
-                      ? 1.0
-                      : ((* p_proc_get) (client_handle, (LINEST_X_COLOFF-1) + i, r));
-
-            c_r = ((* p_proc_get) (client_handle, LINEST_Y_COLOFF, r));
-
-            *v_i += a_ir * c_r;
-        }
+        linest_accumulator_dispose(&linest_accumulator);
+        return(status);
     }
 
-    /* fill M matrix (transpose(A).A) */
-    for(i = 0; i < m; ++i)
+    for(r = 0; r < n; ++r)
     {
-        for(j = 0; j < m; ++j)
-        {
-            /* Mij = sum_over_r(a_ir * a_jr) */
-            P_F64 m_ij = &M[i + (j * m)];
+        const F64 c_r = ((* p_proc_get) (client_handle, LINEST_Y_COLOFF, r));
 
-            for(*m_ij = 0.0, r = 0; r < n; ++r)
-            {
-                a_ir = (i == 0)
-                          ? 1.0
-                          : ((* p_proc_get) (client_handle, (LINEST_X_COLOFF-1) + i, r));
-
-                if(i == j)
-                    a_jr = a_ir;
-                else
-                    a_jr = (j == 0)
-                              ? 1.0
-                              : ((* p_proc_get) (client_handle, (LINEST_X_COLOFF-1) + j, r));
-
-                *m_ij += a_ir * a_jr;
-            }
-        }
+        for(i = 0; i < ext_m; ++i)
+            linest_accumulator.x[i] = ((* p_proc_get) (client_handle, LINEST_X_COLOFF + i, r));
+
+        linest_accumulator_add(&linest_accumulator, linest_accumulator.x, c_r);
     }
 
-    if(status_ok(status = linest_solve_system(M, V, X, m)))
+    if(status_ok(status = linest_accumulator_solve(&linest_accumulator, X)))
     {
         STATUS put_status;
 
         /* output the result vector */
-        for(i = 0; i < m; ++i)
+        for(i = 0; i < linest_accumulator.m; ++i)
             if(status_fail(put_status = (* p_proc_put) (client_handle, LINEST_A_COLOFF, i, X[i])))
                 if(status_ok(status))
                     status = put_status;
@@ -252,6 +398,8 @@ linest(
 
     al_ptr_dispose(P_P_ANY_PEDANTIC(&X));
 
+    linest_accumulator_dispose(&linest_accumulator);
+
     return(status);
 }
 
@@ -53,10 +53,47 @@ _proc_name( \
     _In_        LINEST_ROWOFF row, \
     _InVal_     F64 value)
 
+/*
+one-pass least squares: the normal equations are summed up a data point
+at a time so the data need never be held (or fetched more than once)
+*/
+
+typedef struct LINEST_ACCUMULATOR
+{
+    U32 m;      /* number of estimation parameters (independent x variables + 1) */
+    U32 n;      /* number of data points accumulated */
+    P_F64 M;    /* [m][m] transpose(A).A - only the upper triangle is summed */
+    P_F64 V;    /* [m] transpose(A).C */
+    P_F64 x;    /* [m-1] somewhere for the caller to build up each data point */
+}
+LINEST_ACCUMULATOR, * P_LINEST_ACCUMULATOR;
+
 /*
 exported functions
 */
 
+_Check_return_
+extern STATUS
+linest_accumulator_init(
+    _OutRef_    P_LINEST_ACCUMULATOR p_linest_accumulator,
+    _InVal_     U32 ext_m /* number of independent x variables */);
+
+extern void
+linest_accumulator_add(
+    _InoutRef_  P_LINEST_ACCUMULATOR p_linest_accumulator,
+    _In_reads_(ext_m) PC_F64 x,
+    _InVal_     F64 y);
+
+_Check_return_
+extern STATUS
+linest_accumulator_solve(
+    _InoutRef_  P_LINEST_ACCUMULATOR p_linest_accumulator,
+    _Out_writes_(m) P_F64 X);
+
+extern void
+linest_accumulator_dispose(
+    _InoutRef_  P_LINEST_ACCUMULATOR p_linest_accumulator);
+
 _Check_return_
 extern STATUS
 linest(
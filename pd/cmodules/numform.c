@@ -698,10 +698,18 @@ convert_number_standard(
     if(ss_data_is_real(&p_numform_info->ss_data))
     {
         P_USTR ustr;
+        U32 n_digits;
 
-        consume_int(ustr_xsnprintf(p_numform_info->ustr_integer_section, p_numform_info->elemof_integer_section,
-                                   USTR_TEXT("%#.*f"), /* NB # flag forces f conversion to always have decimal point */
-                                   (int) p_numform_info->decimal_places_format, ss_data_get_real(&p_numform_info->ss_data)));
+        /* whole numbers are done without the general conversion; %#.*f would just add zeros after the point, which get stripped below */
+        if(0 != (n_digits = fast_dtoa_integral((P_U8Z) p_numform_info->ustr_integer_section, p_numform_info->elemof_integer_section - 1, ss_data_get_real(&p_numform_info->ss_data))))
+        {
+            PtrPutByteOff(p_numform_info->ustr_integer_section, n_digits, CH_FULL_STOP);
+            PtrPutByteOff(p_numform_info->ustr_integer_section, n_digits + 1, CH_NULL);
+        }
+        else
+            consume_int(ustr_xsnprintf(p_numform_info->ustr_integer_section, p_numform_info->elemof_integer_section,
+                                       USTR_TEXT("%#.*f"), /* NB # flag forces f conversion to always have decimal point */
+                                       (int) p_numform_info->decimal_places_format, ss_data_get_real(&p_numform_info->ss_data)));
         trace_1(TRACE_MODULE_NUMFORM, TEXT("numform stdfmt(f) : %s"), report_ustr(p_numform_info->ustr_integer_section));
 
         if(PtrGetByte(p_numform_info->ustr_integer_section) == CH_DIGIT_ZERO)
@@ -1102,7 +1110,8 @@ numform_numeric_section_copy_and_parse(
     P_NUMFORM_INFO p_numform_info,
     _Out_writes_z_(elemof_buffer) P_USTR ustr_buf,
     _InVal_     U32 elemof_buffer,
-    _In_z_      PC_USTR ustr_numform_section)
+    _In_z_      PC_USTR ustr_numform_section,
+    _OutRef_opt_ P_PC_USTR p_ustr_section_end)
 {
     const P_U8 buffer = (P_U8) ustr_buf;
     U32 dst_idx = 0;
@@ -1374,6 +1383,10 @@ numform_numeric_section_copy_and_parse(
         dst_idx = elemof_buffer - 1;
     buffer[dst_idx++] = CH_NULL;
 
+    /* just past the terminating CH_SEMICOLON or CH_NULL */
+    if(NULL != p_ustr_section_end)
+        *p_ustr_section_end = ustr_numform_section;
+
     if(!p_numform_info->decimal_pt)
         p_numform_info->decimal_pt = CH_FULL_STOP;
 
@@ -1388,6 +1401,160 @@ numform_numeric_section_copy_and_parse(
     return(shift_value);
 }
 
+/******************************************************************************
+*
+* cache of parsed numeric sections
+*
+* the same few formats get applied over and over on redraw, print and
+* export, so keep what the parse of each recent section produced, keyed
+* by the section's characters up to and including its terminator; the
+* lookup list and style name are kept as offsets into the section, as
+* those point back into the caller's format string
+*
+* only the parse made at the start of numform() comes here, when all the
+* format fields it leaves start off clear
+*
+******************************************************************************/
+
+#define NUMFORM_PARSE_CACHE_ENTRIES 8
+
+typedef struct NUMFORM_PARSE_CACHE_ENTRY
+{
+    U32 key_len;                /* 0 if entry unused */
+    UCHARZ key[BUF_SECTION_MAX];
+    UCHARZ buffer[BUF_SECTION_MAX];
+    S32 shift_value;
+    S32 lookup_section_offset;  /* -1 if none */
+    S32 style_name_offset;      /* -1 if none */
+    NUMFORM_INFO numform_info;  /* format fields as left by the parse */
+}
+NUMFORM_PARSE_CACHE_ENTRY, * P_NUMFORM_PARSE_CACHE_ENTRY;
+
+static NUMFORM_PARSE_CACHE_ENTRY numform_parse_cache[NUMFORM_PARSE_CACHE_ENTRIES];
+
+static U32 numform_parse_cache_next = 0; /* entry to replace next */
+
+static void
+numform_parse_fields_copy(
+    _OutRef_    P_NUMFORM_INFO p_numform_info_out,
+    _InRef_     P_NUMFORM_INFO p_numform_info_in)
+{
+    p_numform_info_out->integer_places_format  = p_numform_info_in->integer_places_format;
+    p_numform_info_out->decimal_places_format  = p_numform_info_in->decimal_places_format;
+    p_numform_info_out->exponent_places_format = p_numform_info_in->exponent_places_format;
+
+    p_numform_info_out->integer_places_actual  = p_numform_info_in->integer_places_actual;
+    p_numform_info_out->decimal_places_actual  = p_numform_info_in->decimal_places_actual;
+    p_numform_info_out->exponent_places_actual = p_numform_info_in->exponent_places_actual;
+
+    p_numform_info_out->exponent_sign          = p_numform_info_in->exponent_sign;
+    p_numform_info_out->thousands_sep          = p_numform_info_in->thousands_sep;
+    p_numform_info_out->decimal_pt             = p_numform_info_in->decimal_pt;
+
+    p_numform_info_out->engineering            = p_numform_info_in->engineering;
+    p_numform_info_out->exponential            = p_numform_info_in->exponential;
+    p_numform_info_out->roman                  = p_numform_info_in->roman;
+    p_numform_info_out->spreadsheet            = p_numform_info_in->spreadsheet;
+    p_numform_info_out->base                   = p_numform_info_in->base;
+    p_numform_info_out->base_basechar          = p_numform_info_in->base_basechar;
+
+    p_numform_info_out->decimal_section_has_hash = p_numform_info_in->decimal_section_has_hash;
+    p_numform_info_out->decimal_section_has_zero = p_numform_info_in->decimal_section_has_zero;
+    p_numform_info_out->decimal_section_spaces   = p_numform_info_in->decimal_section_spaces;
+    p_numform_info_out->exponent_section_spaces  = p_numform_info_in->exponent_section_spaces;
+
+    p_numform_info_out->integer_section_result_output = p_numform_info_in->integer_section_result_output;
+
+    p_numform_info_out->ustr_engineering_section = NULL;
+}
+
+/* does the section start with this entry's key? stops at the first difference so never reads beyond the section */
+
+_Check_return_
+static BOOL
+numform_parse_cache_match(
+    _InRef_     P_NUMFORM_PARSE_CACHE_ENTRY p_entry,
+    _In_z_      PC_USTR ustr_section)
+{
+    PC_U8 p_u8 = (PC_U8) ustr_section;
+    U32 i;
+
+    for(i = 0; i < p_entry->key_len; ++i)
+        if(p_entry->key[i] != p_u8[i])
+            return(FALSE);
+
+    return(0 != p_entry->key_len);
+}
+
+static S32
+numform_numeric_section_copy_and_parse_cached(
+    P_NUMFORM_INFO p_numform_info,
+    _Out_writes_z_(elemof_buffer) P_USTR ustr_buf,
+    _InVal_     U32 elemof_buffer,
+    _In_z_      PC_USTR ustr_numform_section)
+{
+    P_NUMFORM_PARSE_CACHE_ENTRY p_entry;
+    PC_USTR ustr_section_end;
+    S32 shift_value;
+    U32 key_len;
+    U32 i;
+
+    if(elemof_buffer != sizeof32(p_entry->buffer))
+        return(numform_numeric_section_copy_and_parse(p_numform_info, ustr_buf, elemof_buffer, ustr_numform_section, NULL));
+
+    for(i = 0; i < NUMFORM_PARSE_CACHE_ENTRIES; ++i)
+    {
+        p_entry = &numform_parse_cache[i];
+
+        if(!numform_parse_cache_match(p_entry, ustr_numform_section))
+            continue;
+
+        memcpy32(ustr_buf, p_entry->buffer, elemof_buffer);
+
+        numform_parse_fields_copy(p_numform_info, &p_entry->numform_info);
+
+        p_numform_info->ustr_lookup_section = (p_entry->lookup_section_offset < 0) ? NULL
+            : de_const_cast(P_USTR, PtrAddBytes(PC_USTR, ustr_numform_section, p_entry->lookup_section_offset));
+
+        p_numform_info->ustr_style_name = (p_entry->style_name_offset < 0) ? NULL
+            : de_const_cast(P_USTR, PtrAddBytes(PC_USTR, ustr_numform_section, p_entry->style_name_offset));
+
+        return(p_entry->shift_value);
+    }
+
+    shift_value = numform_numeric_section_copy_and_parse(p_numform_info, ustr_buf, elemof_buffer, ustr_numform_section, &ustr_section_end);
+
+    key_len = PtrDiffBytesU32(ustr_section_end, ustr_numform_section);
+
+    /* an exponent at the very end leaves the parse sitting on the CH_NULL, which must be part of the key too */
+    if((0 == key_len) || (CH_NULL != PtrGetByteOff(ustr_numform_section, key_len - 1)))
+        if(CH_NULL == PtrGetByte(ustr_section_end))
+            key_len += 1;
+
+    if(key_len > sizeof32(p_entry->key))
+        return(shift_value); /* too long to bother with */
+
+    p_entry = &numform_parse_cache[numform_parse_cache_next];
+
+    if(++numform_parse_cache_next >= NUMFORM_PARSE_CACHE_ENTRIES)
+        numform_parse_cache_next = 0;
+
+    p_entry->key_len = key_len;
+    memcpy32(p_entry->key, ustr_numform_section, key_len);
+    memcpy32(p_entry->buffer, ustr_buf, elemof_buffer);
+    p_entry->shift_value = shift_value;
+
+    p_entry->lookup_section_offset = (NULL == p_numform_info->ustr_lookup_section) ? -1
+        : (S32) PtrDiffBytesU32(p_numform_info->ustr_lookup_section, ustr_numform_section);
+
+    p_entry->style_name_offset = (NULL == p_numform_info->ustr_style_name) ? -1
+        : (S32) PtrDiffBytesU32(p_numform_info->ustr_style_name, ustr_numform_section);
+
+    numform_parse_fields_copy(&p_entry->numform_info, p_numform_info);
+
+    return(shift_value);
+}
+
 /* loop outputting chars from data under control of format */
 
 _Check_return_
@@ -2193,7 +2360,7 @@ numform_section_extract_numeric(
     }
 
     trace_1(TRACE_MODULE_NUMFORM, TEXT("numform buffer 1 %s"), report_ustr(ustr_section));
-    shift_value = numform_numeric_section_copy_and_parse(p_numform_info, ustr_buf, elemof_buffer, ustr_section);
+    shift_value = numform_numeric_section_copy_and_parse_cached(p_numform_info, ustr_buf, elemof_buffer, ustr_section);
     trace_1(TRACE_MODULE_NUMFORM, TEXT("numform buffer 2 %s"), report_ustr(ustr_buf));
 
     if(shift_value)
@@ -2214,7 +2381,7 @@ numform_section_extract_numeric(
         p_numform_info->number.insert_minus_sign = 0; /* as we are forcing the format */
 
         (void) numform_numeric_section_copy_and_parse(p_numform_info, ustr_buf, elemof_buffer,
-                                                      p_numform_info->number.negative ? USTR_TEXT("-#") : USTR_TEXT("#"));
+                                                      p_numform_info->number.negative ? USTR_TEXT("-#") : USTR_TEXT("#"), NULL);
 
         consume_int(ustr_xsnprintf(p_numform_info->ustr_integer_section, p_numform_info->elemof_integer_section,
                                    USTR_TEXT("%s"),
@@ -443,6 +443,72 @@ ss_array_make(
     return(STATUS_OK);
 }
 
+/******************************************************************************
+*
+* unpack an array whose elements are all numbers into a dense row-major
+* buffer of reals, walking the elements in store order rather than
+* indexing and normalising each one
+*
+* returns FALSE at the first element that is not a plain number, leaving
+* the caller to take the general per-element route
+*
+******************************************************************************/
+
+_Check_return_
+extern BOOL
+ss_array_reals_read(
+    _Out_writes_(x_size*y_size) P_F64 p_f64,
+    _InRef_     PC_SS_DATA p_ss_data)
+{
+    const S32 n_elements = p_ss_data->arg.ss_array.x_size * p_ss_data->arg.ss_array.y_size;
+    PC_SS_DATA p_ss_data_ele = p_ss_data->arg.ss_array.elements;
+    S32 i;
+
+    assert( (ss_data_get_data_id(p_ss_data) == RPN_TMP_ARRAY) || (ss_data_get_data_id(p_ss_data) == RPN_RES_ARRAY) );
+
+    for(i = 0; i < n_elements; ++i, ++p_ss_data_ele)
+    {
+        switch(ss_data_get_data_id(p_ss_data_ele))
+        {
+        case DATA_ID_REAL:
+            p_f64[i] = ss_data_get_real(p_ss_data_ele);
+            break;
+
+        case DATA_ID_WORD16:
+        case DATA_ID_WORD32:
+            p_f64[i] = (F64) ss_data_get_integer(p_ss_data_ele);
+            break;
+
+        default:
+            return(FALSE);
+        }
+    }
+
+    return(TRUE);
+}
+
+/******************************************************************************
+*
+* set every element of an array made by ss_array_make()
+* from a dense row-major buffer of reals
+*
+******************************************************************************/
+
+extern void
+ss_array_reals_write(
+    _InoutRef_  P_SS_DATA p_ss_data,
+    _In_reads_(x_size*y_size) PC_F64 p_f64)
+{
+    const S32 n_elements = p_ss_data->arg.ss_array.x_size * p_ss_data->arg.ss_array.y_size;
+    P_SS_DATA p_ss_data_ele = p_ss_data->arg.ss_array.elements;
+    S32 i;
+
+    assert(ss_data_get_data_id(p_ss_data) == RPN_TMP_ARRAY);
+
+    for(i = 0; i < n_elements; ++i, ++p_ss_data_ele)
+        ss_data_set_real(p_ss_data_ele, p_f64[i]);
+}
+
 /******************************************************************************
 *
 * sets equal type numbers for equivalent types
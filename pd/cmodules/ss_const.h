@@ -44,7 +44,7 @@
 typedef U8                  EV_DOCNO; typedef EV_DOCNO * P_EV_DOCNO; /* NB same as DOCNO */
 #define EV_DOCNO_BITS       8
 
-typedef int                 EV_COL;
+typedef int                 EV_COL; typedef EV_COL * P_EV_COL;
 #define EV_COL_BITS         32
 #define EV_COL_SBF          SBF
 
@@ -418,6 +418,17 @@ ss_array_make(
     _InVal_     S32 x_size,
     _InVal_     S32 y_size);
 
+_Check_return_
+extern BOOL
+ss_array_reals_read(
+    _Out_writes_(x_size*y_size) P_F64 p_f64,
+    _InRef_     PC_SS_DATA p_ss_data);
+
+extern void
+ss_array_reals_write(
+    _InoutRef_  P_SS_DATA p_ss_data,
+    _In_reads_(x_size*y_size) PC_F64 p_f64);
+
 _Check_return_
 extern bool
 ss_data_get_logical(
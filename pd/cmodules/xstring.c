@@ -191,6 +191,82 @@ fast_strtol(
 
 #endif
 
+/******************************************************************************
+*
+* convert a whole number in [0, 1E15) to its decimal digits
+*
+* these come out just the same as from %.15g or %.0f, and are produced in
+* two U32 halves rather than by the general printf conversion
+*
+* returns the number of digits output, or zero (having output nothing)
+* for negative, non-integral or larger values, which need the long way
+*
+******************************************************************************/
+
+_Check_return_
+extern U32
+fast_dtoa_integral(
+    _Out_writes_z_(elemof_buffer) P_U8Z p_u8_out,
+    _InVal_     U32 elemof_buffer,
+    _InVal_     F64 f64)
+{
+    U8Z buffer[16]; /* 15 digits + CH_NULL */
+    P_U8Z p_u8 = buffer + elemof32(buffer);
+    F64 f64_lo;
+    U32 hi, lo;
+    U32 n_digits;
+
+    /* NB !(f64 >= 0.0) also rejects NaN; -0.0 must give "-0" so goes the long way too */
+    if(!(f64 >= 0.0) || (f64 >= 1E15) || (floor(f64) != f64) || (copysign(1.0, f64) < 0.0))
+        return(0);
+
+    /* both halves are exact as f64 is a whole number below 2^53 */
+    hi = (U32) floor(f64 / 1E8);
+    f64_lo = f64 - ((F64) hi * 1E8);
+
+    if(f64_lo < 0.0)
+    {
+        hi -= 1;
+        f64_lo += 1E8;
+    }
+    else if(f64_lo >= 1E8)
+    {
+        hi += 1;
+        f64_lo -= 1E8;
+    }
+
+    lo = (U32) f64_lo;
+
+    *--p_u8 = CH_NULL;
+
+    if(0 != hi)
+    {
+        U32 i;
+
+        for(i = 0; i < 8; ++i)
+        {
+            *--p_u8 = (U8) (CH_DIGIT_ZERO + (lo % 10));
+            lo /= 10;
+        }
+
+        lo = hi;
+    }
+
+    do  {
+        *--p_u8 = (U8) (CH_DIGIT_ZERO + (lo % 10));
+        lo /= 10;
+    }
+    while(0 != lo);
+
+    n_digits = PtrDiffBytesU32(buffer + elemof32(buffer) - 1, p_u8);
+
+    if(n_digits >= elemof_buffer)
+        return(0);
+
+    memcpy32(p_u8_out, p_u8, n_digits + 1);
+    return(n_digits);
+}
+
 _Check_return_
 extern U32
 fast_strtoul(
@@ -80,6 +80,13 @@ check_sorted(
         const void * a1,
         const void * a2));
 
+_Check_return_
+extern U32
+fast_dtoa_integral(
+    _Out_writes_z_(elemof_buffer) P_U8Z p_u8_out, /* NB NOT USTR */
+    _InVal_     U32 elemof_buffer,
+    _InVal_     F64 f64);
+
 _Check_return_
 extern U32
 fast_strtoul(
@@ -322,7 +322,6 @@ stricmp_wild(
     /* must skip leading hilites in template string for final rejection */
     while(is_control(*ptr2))
         ++ptr2;
-    x = ptr2 - 1;
 
     end_y = ptr1;
     while(*end_y)
@@ -331,6 +330,35 @@ stricmp_wild(
         while(end_y[-1] == CH_SPACE)
             --end_y;
 
+    /* most strings carry neither highlights nor wildcards, so first try a
+     * straight case-folded pass, which gives the same answer as the loops
+     * below up to the first highlight or wildcard, and only fall into those
+     * should one turn up before the comparison is decided
+    */
+    x = ptr2;
+    y = ptr1;
+
+    for(;;)
+    {
+        if(is_control(*x) || is_control(*y) || (*x == CH_CIRCUMFLEX_ACCENT))
+            break;
+
+        if(y == end_y)
+            return((x == end_x) ? 0 : -1);
+
+        if(*x != *y)
+        {
+            pos_res = toupper(*y) - toupper(*x);
+
+            if(0 != pos_res)
+                return(pos_res);
+        }
+
+        ++x;
+        ++y;
+    }
+
+    x = ptr2 - 1;
     y = ptr1;
 
 STAR:
@@ -35,6 +35,7 @@ typedef struct SORT_ENTRY
 {
     ROW keyrow;
     ROW rowsinrec;
+    S32 keyix;  /* record's keys start at sort_keys[keyix * fields] */
 }
 SORT_ENTRY, * P_SORT_ENTRY;
 
@@ -42,6 +43,7 @@ SORT_ENTRY, * P_SORT_ENTRY;
 
 static S32 fields;
 static struct SORT_FIELD sort_fields[SORT_FIELD_DEPTH];
+static P_SS_DATA sort_keys;
 
 /******************************************************************************
 *
@@ -742,7 +744,10 @@ static jmp_buf sortpoint;
 
 PROC_QSORT_PROTO(static, rowcomp, SORT_ENTRY)
 {
-    EV_SLR slr1, slr2;
+    const P_SORT_ENTRY p_sort_entry_1 = (P_SORT_ENTRY) _arg1;
+    const P_SORT_ENTRY p_sort_entry_2 = (P_SORT_ENTRY) _arg2;
+    PC_SS_DATA p_key_1 = sort_keys + p_sort_entry_1->keyix * fields;
+    PC_SS_DATA p_key_2 = sort_keys + p_sort_entry_2->keyix * fields;
     S32 res;
     COL col;
 
@@ -751,27 +756,13 @@ PROC_QSORT_PROTO(static, rowcomp, SORT_ENTRY)
     current_p_docu_global_register_restore_from_backup();
 
     col = 0;
-    slr1.docno = slr2.docno = (EV_DOCNO) current_docno();
 
     do  {
-        SS_DATA data1, data2;
-
         /* make long sorts escapeable - at this point no data has been exchanged */
         if(ctrlflag)
             longjmp(sortpoint, 1);
 
-        slr1.col   = slr2.col = (EV_COL) sort_fields[col].column;
-        slr1.row   = (EV_ROW) ((P_SORT_ENTRY) _arg1)->keyrow;
-        slr2.row   = (EV_ROW) ((P_SORT_ENTRY) _arg2)->keyrow;
-        slr1.flags = slr2.flags = 0;
-
-        ev_slr_deref(&data1, &slr1, FALSE);
-        ev_slr_deref(&data2, &slr2, FALSE);
-
-        res = ss_data_compare(&data1, &data2);
-
-        ss_data_free_resources(&data1);
-        ss_data_free_resources(&data2);
+        res = ss_data_compare(&p_key_1[col], &p_key_2[col]);
 
         /* if equal at this column, loop */
         if(res)
@@ -780,8 +771,14 @@ PROC_QSORT_PROTO(static, rowcomp, SORT_ENTRY)
     while(++col < fields);
 
     if(res)
+    {
         if(sort_fields[col].reverse)
             res = (res > 0) ? -1 : 1;
+    }
+    else if(p_sort_entry_1->keyrow != p_sort_entry_2->keyrow)
+    {   /* keep records with equal keys in their original order */
+        res = (p_sort_entry_1->keyrow > p_sort_entry_2->keyrow) ? 1 : -1;
+    }
 
     current_p_docu_global_register_stash_block_end(); /* restore the register we just trashed for caller (library) */
 
@@ -816,6 +813,12 @@ sortblock_fn_core(void)
     ARRAY_HANDLE sortblkh = 0;
     SC_ARRAY_INIT_BLOCK sortrowblk_init_block = aib_init(1, sizeof32(ROW), FALSE);
     ARRAY_HANDLE sortrowblkh = 0;
+    ARRAY_HANDLE sortatblkh = 0;
+    SC_ARRAY_INIT_BLOCK sortposblk_init_block = aib_init(1, sizeof32(EV_ROW), FALSE);
+    ARRAY_HANDLE sortposblkh = 0;
+    SC_ARRAY_INIT_BLOCK sortkeyblk_init_block = aib_init(1, sizeof32(SS_DATA), FALSE);
+    ARRAY_HANDLE sortkeyblkh = 0;
+    S32 nkeys = 0;
     P_SORT_ENTRY sortblkp, sortp;
     P_ROW sortrowblkp, rowtp;
     STATUS status;
@@ -880,6 +883,14 @@ sortblock_fn_core(void)
 
     trace_1(TRACE_MODULE_UREF, "allocated sort row block, %d entries", ((S32) blkend.row - blkstart.row + 1));
 
+    /* allocate array of sort keys */
+    if(NULL == al_array_alloc(&sortkeyblkh, SS_DATA, nrecs * fields, &sortkeyblk_init_block, &status))
+    {
+        dialog_box_end();
+        res = reperr_null(status);
+        goto endpoint;
+    }
+
     /* switch on indicator */
     actind(0);
 
@@ -901,6 +912,37 @@ sortblock_fn_core(void)
         sortp->rowsinrec = (i--) - sortp->keyrow;
     }
 
+    /* read each record's keys just the once rather than on every comparison */
+    for(rec = 0; rec < nrecs; ++rec)
+    {
+        EV_SLR slr;
+        COL col;
+
+        if(ctrlflag)
+            goto endpoint;
+
+        slr.docno = (EV_DOCNO) current_docno();
+        slr.row   = (EV_ROW) array_ptr(&sortblkh, SORT_ENTRY, rec)->keyrow;
+        slr.flags = 0;
+
+        array_ptr(&sortblkh, SORT_ENTRY, rec)->keyix = rec;
+
+        for(col = 0; col < fields; ++col)
+        {
+            SS_DATA data;
+
+            slr.col = (EV_COL) sort_fields[col].column;
+
+            ev_slr_deref(&data, &slr, FALSE);
+
+            /* must re-load key block pointer each time */
+            *array_ptr(&sortkeyblkh, SS_DATA, nkeys++) = data;
+        }
+    }
+
+    sortblkp = array_base(&sortblkh, SORT_ENTRY);
+    sort_keys = array_base(&sortkeyblkh, SS_DATA);
+
     trace_2(TRACE_MODULE_UREF, "SortBlock: sorting array " PTR_XTFMT", %d elements", report_ptr_cast(sortblkp), nrecs);
 
     if(setjmp(sortpoint))
@@ -935,16 +977,42 @@ sortblock_fn_core(void)
     /* free sort array */
     al_array_dispose(&sortblkh);
 
-    trace_0(TRACE_MODULE_UREF, "sort array freed; exchange starting");
-
     /* exchange the rows in the spreadsheet */
     /* NB. difference between pointers still valid after dealloc */
     nrows = rowtp - sortrowblkp;
 
+    /* allocate tables of which original row is in each row, and where each original row now is */
+    if( (NULL == al_array_alloc(&sortatblkh, ROW, nrows, &sortrowblk_init_block, &status)) ||
+        (NULL == al_array_alloc(&sortposblkh, EV_ROW, nrows, &sortposblk_init_block, &status)) )
+    {
+        dialog_box_end();
+        res = reperr_null(status);
+        goto endpoint;
+    }
+
+    {
+    P_ROW atp = array_base(&sortatblkh, ROW);
+    EV_ROW * posp = array_base(&sortposblkh, EV_ROW);
+
+    for(n = 0; n < nrows; ++n)
+    {
+        atp[n]  = n + blkstart.row;
+        posp[n] = (EV_ROW) (n + blkstart.row);
+    }
+    } /*block*/
+
+    trace_0(TRACE_MODULE_UREF, "sort array freed; exchange starting");
+
+    /* bring each row's record into place by swapping it with whatever is there;
+     * rows above n are already in place so each swap is with a row further down.
+     * references are updated in one pass once the rows have all been moved
+     */
     for(n = 0; n < nrows; ++n)
     {
+        ROW want, cur, displaced;
+
         if(ctrlflag)
-            goto endpoint;
+            break;
 
         actind((S32) ((100 * n) / nrows));
 
@@ -955,60 +1023,56 @@ sortblock_fn_core(void)
         {
             dialog_box_end();
             res = reperr_null(status_nomem());
-            goto endpoint;
+            break;
         }
 
-        /* must re-load row block pointer each time, ahem */
-        assert(array_index_is_valid(&sortrowblkh, n));
-        rowtp = array_ptr(&sortrowblkh, ROW, n);
-        row = n + blkstart.row;
-        if(*rowtp != row)
-        {   /* do physical swap */
-            if(!swap_rows(row,
-                          *rowtp,
-                          blkstart.col,
-                          blkend.col,
-#if 0
-                          updaterefs
-#else
-                          TRUE /* always update refs */
-#endif
-                        ))
-            {
-                res = reperr_null(status_nomem());
-                goto endpoint;
-            }
-            else
-            {   /* update list of unsorted rows */
-                ROW nn;
-                P_ROW nrowtp;
-
-                /* must re-load row block pointer each time, ahem */
-                assert(array_index_is_valid(&sortrowblkh, n));
-                rowtp = array_ptr(&sortrowblkh, ROW, n);
-
-                for(nn = n + 1, nrowtp = rowtp + 1;
-                    nn < nrows;
-                    ++nn, ++nrowtp)
-                {
-                    if(*nrowtp == row)
-                    {
-                        *nrowtp = *rowtp;
-                        break;
-                    }
-                }
-            }
+        /* must re-load block pointers each time, ahem */
+        row  = n + blkstart.row;
+        want = *array_ptr(&sortrowblkh, ROW, n);
+        cur  = (ROW) *array_ptr(&sortposblkh, EV_ROW, want - blkstart.row);
+
+        if(cur == row)
+            continue;
+
+        /* do physical swap */
+        if(!swap_rows(row, cur, blkstart.col, blkend.col, FALSE /* see permuterefs() below */))
+        {
+            res = reperr_null(status_nomem());
+            break;
         }
+
+        /* original row displaced from row has gone to cur */
+        displaced = *array_ptr(&sortatblkh, ROW, n);
+        *array_ptr(&sortatblkh, ROW, cur - blkstart.row) = displaced;
+        *array_ptr(&sortposblkh, EV_ROW, displaced - blkstart.row) = (EV_ROW) cur;
+
+        *array_ptr(&sortatblkh, ROW, n) = want;
+        *array_ptr(&sortposblkh, EV_ROW, want - blkstart.row) = (EV_ROW) row;
     }
 
+    /* update references to the rows as far as they got moved */
+    trace_0(TRACE_MODULE_UREF, "exchange done; updating references");
+    permuterefs(blkstart.row, blkstart.row + nrows - 1, blkstart.col, blkend.col, array_base(&sortposblkh, EV_ROW));
+
 endpoint:
 
     /* free sort array */
     al_array_dispose(&sortblkh);
 
+    /* free sort keys */
+    while(nkeys > 0)
+        ss_data_free_resources(array_ptr(&sortkeyblkh, SS_DATA, --nkeys));
+
+    al_array_dispose(&sortkeyblkh);
+    sort_keys = NULL;
+
     /* free row table array */
     al_array_dispose(&sortrowblkh);
 
+    /* free row position arrays */
+    al_array_dispose(&sortatblkh);
+    al_array_dispose(&sortposblkh);
+
     /* release any redundant storage */
     garbagecollect();
 
@@ -419,6 +419,14 @@ extern void
 pack_column(
     COL col);
 
+extern void
+permuterefs(
+    ROW firstrow,
+    ROW lastrow,
+    COL firstcol,
+    COL lastcol,
+    const EV_ROW * p_new_row);
+
 extern void
 readpcolvars(
     _InVal_     COL col,
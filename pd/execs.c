@@ -847,11 +847,15 @@ SplitLine_fn(void)
         else
             trow = currow + 1;
 
+        ev_uref_batch_start();
+
         updref(0, trow, LARGEST_COL_POSSIBLE, LARGEST_ROW_POSSIBLE, 0, 1, UREF_UREF, DOCNO_NONE);
 
         if(curcol)
             updref(curcol, currow, numcol-1, currow, 0, 1, UREF_UREF, DOCNO_NONE);
 
+        ev_uref_batch_end();
+
         if(been_error)
             return;
     }
@@ -993,6 +997,8 @@ JoinLines_fn(void)
 
             reset_numrow();
 
+            ev_uref_batch_start();
+
             /* mark deleted area */
             updref(curcol, currow, LARGEST_COL_POSSIBLE, currow, BADCOLBIT, 0, UREF_REPLACE, DOCNO_NONE);
 
@@ -1009,6 +1015,8 @@ JoinLines_fn(void)
 
             updref(0, trow, LARGEST_COL_POSSIBLE, LARGEST_ROW_POSSIBLE, 0, -1, UREF_UREF, DOCNO_NONE);
 
+            ev_uref_batch_end();
+
             out_rebuildvert = xf_flush = TRUE;
             filealtered(TRUE);
             mark_to_end(currowoffset-1);
@@ -1068,12 +1076,16 @@ DeleteRowInColumn_fn(void)
 
     reset_numrow();
 
+    ev_uref_batch_start();
+
     /* anything pointing to deleted cells in this row become bad */
     updref(curcol, currow,     curcol, currow,               BADCOLBIT, (ROW) 0, UREF_DELETE, DOCNO_NONE);
 
     /* rows in all those columns move up */
     updref(curcol, currow + 1, curcol, LARGEST_ROW_POSSIBLE, (COL) 0, (ROW) -1, UREF_UREF, DOCNO_NONE);
 
+    ev_uref_batch_end();
+
     mark_to_end(currowoffset);
 }
 
@@ -218,6 +218,7 @@ ev_ext_uref(
     case UREF_UREF:
     case UREF_DELETE:
     case UREF_SWAP:
+    case UREF_PERMUTE:
     case UREF_CHANGEDOC:
     case UREF_REPLACE:
     case UREF_SWAPCELL:
@@ -1300,6 +1300,7 @@ PROC_UREF_PROTO(static, draw_uref)
     case UREF_UREF:
     case UREF_DELETE:
     case UREF_SWAP:
+    case UREF_PERMUTE:
     case UREF_SWAPCELL:
     case UREF_CLOSE:
         {
@@ -1310,6 +1311,7 @@ PROC_UREF_PROTO(static, draw_uref)
             switch(upp->action)
             {
             case UREF_SWAP:
+            case UREF_PERMUTE:
             case UREF_SWAPCELL:
             case UREF_UREF:
                 p_draw_file_ref->col = at_rng->s.col;
@@ -1759,6 +1761,7 @@ PROC_UREF_PROTO(static, graph_uref)
     case UREF_UREF:
     case UREF_DELETE:
     case UREF_SWAP:
+    case UREF_PERMUTE:
     case UREF_SWAPCELL:
     case UREF_CLOSE:
         {
@@ -1812,6 +1815,12 @@ PROC_UREF_PROTO(static, graph_uref)
                 graph_send_block(glp, upp->slr1.col, upp->slr2.row, upp->slr2.col, upp->slr2.row + 1);
                 break;
 
+            case UREF_PERMUTE:
+                glp->col = at_rng->s.col;
+                glp->row = at_rng->s.row;
+                graph_send_block(glp, upp->slr1.col, upp->slr1.row, upp->slr2.col, upp->slr2.row);
+                break;
+
             case UREF_SWAPCELL:
                 glp->col = at_rng->s.col;
                 glp->row = at_rng->s.row;
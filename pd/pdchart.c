@@ -2047,6 +2047,7 @@ PROC_UREF_PROTO(static, pdchart_uref_handler)
     case UREF_UREF:
     case UREF_DELETE:
     case UREF_SWAP:
+    case UREF_PERMUTE:
     case UREF_CHANGEDOC:
     case UREF_CHANGE:
     /*case UREF_REPLACE:*/
@@ -2268,6 +2269,57 @@ PROC_UREF_PROTO(static, pdchart_uref_handler)
         }
         break; /* end of UREF_SWAP */
 
+    case UREF_PERMUTE:
+        {
+        trace_6(TRACE_MODULE_GR_CHART,
+                "pdchart_uref_handler: UREF_PERMUTE for (%d,%d,%d), (%d,%d,%d)",
+                upp->slr1.docno, upp->slr1.col, upp->slr1.row,
+                upp->slr2.docno, upp->slr2.col, upp->slr2.row);
+
+        /* the rows of a block (upp->slr1, upp->slr2) in the range have been reordered: recalc */
+
+        switch(itdep->type)
+        {
+        case PDCHART_RANGE_COL:
+            /* damage all ranges across this dependency */
+            pdchart_damage_chart_for_dep(pdchart, itdep);
+            break;
+
+        default:
+            myassert1x(0, "chart dep type %d not COL or ROW", itdep->type);
+
+            /* deliberate drop thru ... */
+
+        case PDCHART_RANGE_ROW:
+            /* damage just the moved rows and move the refs */
+
+            if(pdchartelem != i_pdchartelem)
+            {
+                while(--pdchartelem >= i_pdchartelem)
+                {
+                    if(pdchartelem->itdepkey == itdepkey)
+                    {
+                        if(pdchartelem->type == PDCHART_RANGE_ROW)
+                        {
+                            const ROW row = pdchartelem->rng.row.row;
+
+                            if( (row >= upp->slr1.row) &&
+                                (row <  upp->slr2.row) &&
+                                (row != upp->p_permute[row - upp->slr1.row]) )
+                            {
+                                pdchartelem->rng.row.row = upp->p_permute[row - upp->slr1.row];
+                                gr_chart_damage(&pdchart->ch, &pdchartelem->gr_int_handle);
+                                modify = 1;
+                            }
+                        }
+                    }
+                }
+            }
+            break;
+        }
+        }
+        break; /* end of UREF_PERMUTE */
+
     case UREF_UREF:
         {
         /* simple motion of deps and elements harmless; just update structures
@@ -2711,6 +2763,7 @@ PROC_UREF_PROTO(static, pdchart_text_uref_handler)
     case UREF_UREF:
     case UREF_DELETE:
     case UREF_SWAP:
+    case UREF_PERMUTE:
     case UREF_CHANGEDOC:
     case UREF_CHANGE:
     /*case UREF_REPLACE:*/
@@ -2808,6 +2861,7 @@ PROC_UREF_PROTO(static, pdchart_text_uref_handler)
     case UREF_CHANGE:
     case UREF_SWAPCELL:
     case UREF_SWAP:
+    case UREF_PERMUTE:
         {
 #if TRACE_ALLOWED
         switch(upp->action)
@@ -2834,6 +2888,14 @@ PROC_UREF_PROTO(static, pdchart_text_uref_handler)
                     upp->slr1.docno, upp->slr1.col, upp->slr1.row,
                     upp->slr2.docno, upp->slr2.col, upp->slr2.row);
             break;
+
+        case UREF_PERMUTE:
+            /* the rows of a block (upp->slr1, upp->slr2) in the range have been reordered: recalc */
+            trace_6(TRACE_MODULE_GR_CHART,
+                    "pdchart_text_uref_handler: UREF_PERMUTE for (%d,%d,%d), (%d,%d,%d)",
+                    upp->slr1.docno, upp->slr1.col, upp->slr1.row,
+                    upp->slr2.docno, upp->slr2.col, upp->slr2.row);
+            break;
         }
 #endif
 
@@ -691,12 +691,24 @@ decode_command_line_options(
                     }
                 break;
 
+            case 'o': /* Output recalc reports to file */
+                arg = argv[++i];
+                if(pass == 2)
+                    recalc_file_report_to(arg);
+                break;
+
             case 'p': /* Print */
                 arg = argv[++i];
                 if(pass == 2)
                     print_file(arg);
                 break;
 
+            case 'r': /* Recalculate and save */
+                arg = argv[++i];
+                if(pass == 2)
+                    recalc_file(arg);
+                break;
+
             case 'q': /* Quit */
                 if(pass == 2)
                     application_process_command(N_Quit);
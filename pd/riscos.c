@@ -323,6 +323,101 @@ print_file(
 
 /* ----------------------------------------------------------------------- */
 
+/* where recalc_file() writes its per-sheet report; stdout if not named */
+
+static TCHARZ recalc_report_filename[BUF_MAX_PATHSTRING];
+
+extern void
+recalc_file_report_to(
+    _In_z_      PCTSTR filename)
+{
+    tstr_xstrkpy(recalc_report_filename, elemof32(recalc_report_filename), filename);
+}
+
+static void
+recalc_file_report(
+    _In_z_      PCTSTR report)
+{
+    FILE * fout = stdout;
+
+    reportf("recalc_file: %s", report);
+
+    if(CH_NULL != recalc_report_filename[0])
+        if(NULL == (fout = fopen(recalc_report_filename, "a")))
+            return;
+
+    fprintf(fout, "%s\n", report);
+
+    if(stdout != fout)
+        fclose(fout);
+    else
+        fflush(fout);
+}
+
+/* load a file, recalculate it to completion and save it back out,
+ * reporting how long that took (for batch use from the command line)
+*/
+
+extern void
+recalc_file(
+    _In_z_      PCTSTR filename)
+{
+    STATUS filetype_option;
+    TCHARZ report[BUF_MAX_PATHSTRING + 64];
+
+    reportf("recalc_file(%u:%s)", strlen32(filename), filename);
+
+    filetype_option = find_filetype_option(filename, FILETYPE_UNDETERMINED);
+
+    if(PD4_CHART_CHAR == filetype_option)
+        return;
+
+    if(riscos_LoadFile(filename, FALSE, filetype_option /*may be 0,Err*/)) /* load as new file */
+    {
+        const U32 cells_calced_before = ev_recalc_cells_calced;
+        const MONOTIME time_started = monotime();
+        MONOTIMEDIFF time_taken;
+        BOOL complete;
+
+        /* as ev_recalc_all(), but without an error box if escaped */
+        escape_enable();
+
+        while(!ctrlflag  &&  ev_todo_check())
+            ev_recalc();
+
+        complete = (escape_disable_nowinge() >= 0)  &&  !ev_todo_check();
+
+        time_taken = monotime_diff(time_started);
+
+        consume_int(xsnprintf(report, elemof32(report),
+                    "%s: %u cells evaluated in %d.%02ds%s",
+                    filename,
+                    ev_recalc_cells_calced - cells_calced_before,
+                    time_taken / MONOTIME_TICKS_PER_SECOND,
+                    ((time_taken % MONOTIME_TICKS_PER_SECOND) * 100) / MONOTIME_TICKS_PER_SECOND,
+                    complete ? "" : " (interrupted, not saved)"));
+
+        recalc_file_report(report);
+
+        if(complete)
+        {
+            SAVE_FILE_OPTIONS save_file_options;
+            save_file_options_init(&save_file_options, current_filetype_option, current_line_sep_option);
+            (void) savefile(currentfilename(), &save_file_options);
+        }
+
+        destroy_current_document();
+    }
+    else
+    {
+        consume_int(xsnprintf(report, elemof32(report), "%s: not loaded", filename));
+
+        recalc_file_report(report);
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+
 extern BOOL
 riscos_quit_okayed(
     S32 nmodified)
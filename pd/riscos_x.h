@@ -184,6 +184,14 @@ extern void
 print_file(
     _In_z_      PCTSTR filename);
 
+extern void
+recalc_file(
+    _In_z_      PCTSTR filename);
+
+extern void
+recalc_file_report_to(
+    _In_z_      PCTSTR filename);
+
 extern void
 filer_opendir(
     _In_z_      PCTSTR filename);
@@ -587,9 +587,9 @@ garbagecollect(void)
 {
     COL tcol = numcol;
 
+    /* list_garbagecollect() coalesces each run of fillers in one pass */
     while(--tcol >= 0)
-        while(list_garbagecollect(indexcollb(tcol)))
-            ;
+        (void) list_garbagecollect(indexcollb(tcol));
 }
 
 /******************************************************************************
@@ -1287,6 +1287,34 @@ sortrefs(
     ev_uref(&urefb);
 }
 
+/******************************************************************************
+*
+* update references when the rows of a block have been reordered in sort
+*
+* p_new_row[n] is the row now holding what was in row firstrow + n
+*
+******************************************************************************/
+
+extern void
+permuterefs(
+    ROW firstrow,
+    ROW lastrow,
+    COL firstcol,
+    COL lastcol,
+    const EV_ROW * p_new_row)
+{
+    UREF_PARM urefb;
+
+    /* set up uref block */
+    set_ev_slr(&urefb.slr1,    firstcol, firstrow);
+    set_ev_slr(&urefb.slr2, lastcol + 1, lastrow + 1);
+
+    urefb.action = UREF_PERMUTE;
+    urefb.p_permute = p_new_row;
+
+    ev_uref(&urefb);
+}
+
 /******************************************************************************
 *
 * swap the rows, can assume cells exist in all columns
@@ -1306,8 +1334,6 @@ swap_rows(
     char temp[MAX_SLOTSIZE];
     swap_cell_struct s1, s2;
 
-    UNREFERENCED_PARAMETER(updaterefs);
-
     trace_2(TRACE_APP_PD4, "swap rows: %d, %d", (S32) trow1, (S32) trow2);
 
     s1.row = trow1;
@@ -1363,8 +1389,12 @@ swap_rows(
         }
     }
 
-    trace_0(TRACE_APP_PD4, "swap_rows: update references");
-    sortrefs(s1.row, s2.row, firstcol, lastcol);
+    /* caller may update references for many swaps at once */
+    if(updaterefs)
+    {
+        trace_0(TRACE_APP_PD4, "swap_rows: update references");
+        sortrefs(s1.row, s2.row, firstcol, lastcol);
+    }
 
     trace_0(TRACE_APP_PD4, "swap_rows out");
 